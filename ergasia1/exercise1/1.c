@@ -3,10 +3,16 @@
 #include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
-
-#define LOWER_BOUND -20
-#define UPPER_BOUND 20
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include "poly.h"
+#include "rng.h"
+#include "ntt.h"
+#include "batch.h"
+#include "dispatch.h"
+#include "polyio.h"
+#include "kernels.h"
 
 typedef struct {
     int start_i;
@@ -18,34 +24,33 @@ typedef struct {
     int *result_local;
 } thread_data_t;
 
-int *create_random_polynomial(int degree)
-{
-    int *poly = (int *)malloc((size_t)(degree + 1) * sizeof(int));
-    if (!poly) {
-        perror("malloc");
-        exit(EXIT_FAILURE);
-    }
-    for (int i = 0; i <= degree; ++i) {
-        poly[i] = (rand() % (UPPER_BOUND - LOWER_BOUND + 1)) + LOWER_BOUND;
-    }
-    return poly;
-}
+typedef struct {
+    int start_k;
+    int end_k;
+    int degree1;
+    int degree2;
+    const int *poly1;
+    const int *poly2;
+    int *result;
+} output_data_t;
 
-int *multiply_sequential(const int *poly1, int deg1, const int *poly2, int deg2)
-{
-    int result_len = deg1 + deg2 + 1;
-    int *result = (int *)calloc((size_t)result_len, sizeof(int));
-    if (!result) {
-        perror("calloc");
-        exit(EXIT_FAILURE);
-    }
-    for (int i = 0; i <= deg1; ++i) {
-        for (int j = 0; j <= deg2; ++j) {
-            result[i + j] += poly1[i] * poly2[j];
-        }
-    }
-    return result;
-}
+typedef struct {
+    int start_k;
+    int end_k;
+    int threads;
+    int **locals;
+    int *result;
+} reduce_data_t;
+
+typedef struct {
+    const poly_pair_t *pairs;
+    int first;
+    int last;
+    int *arena;
+    const size_t *offsets;
+} batch_data_t;
+
+int parallel_reduction = 1;     // -r serial sums the private buffers on the main thread instead.
 
 void *multiply_parallel_worker(void *arg)
 {
@@ -58,21 +63,22 @@ void *multiply_parallel_worker(void *arg)
     return NULL;
 }
 
-int results_equal(const int *res1, const int *res2, int degree)
+void *multiply_blocked_worker(void *arg)
 {
-    for (int i = 0; i <= degree; ++i) {
-        if (res1[i] != res2[i]) {
-            return 0;
-        }
-    }
-    return 1;
+    thread_data_t *td = (thread_data_t *)arg;
+    multiply_blocked_kernel(td->poly1, td->start_i, td->end_i, td->poly2, td->degree2, td->result_local);
+    return NULL;
 }
 
-double now_seconds(void)
+void *multiply_output_worker(void *arg)
 {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ts.tv_sec + ts.tv_nsec * 1e-9;
+    output_data_t *od = (output_data_t *)arg;
+    //walk the owned range in TILE_J windows so the result window stays cache resident.
+    for (int kb = od->start_k; kb <= od->end_k; kb += TILE_J) {
+        int ke = (kb + TILE_J - 1 < od->end_k) ? kb + TILE_J - 1 : od->end_k;
+        multiply_output_range(od->poly1, od->degree1, od->poly2, od->degree2, kb, ke, od->result);
+    }
+    return NULL;
 }
 
 void print_polynomial(int *poly, int degree)
@@ -101,7 +107,60 @@ void print_polynomial(int *poly, int degree)
     printf("\n");
 }
 
-void run_parallel_case(int *poly1, int degree1, int *poly2, int degree2, int *baseline, int threads)
+// Sums locals[0..threads-1] over one slice of output coefficients.
+void *reduce_slice_worker(void *arg)
+{
+    reduce_data_t *rd = (reduce_data_t *)arg;
+    int *result = rd->result;
+
+    for (int k = rd->start_k; k <= rd->end_k; ++k) {
+        result[k] = 0;
+    }
+    for (int t = 0; t < rd->threads; ++t) {
+        const int *local = rd->locals[t];
+        #pragma omp simd
+        for (int k = rd->start_k; k <= rd->end_k; ++k) {
+            result[k] += local[k];
+        }
+    }
+    return NULL;
+}
+
+// Each thread reduces its own slice of k across all private buffers. Slices are whole
+// cache lines (16 ints) so no two threads write to the same line of the result.
+void reduce_locals_parallel(int **locals, int threads, int result_len, int *result)
+{
+    pthread_t thread_ids[threads];
+    reduce_data_t data[threads];
+    int lines = (result_len + 15) / 16;
+    int slice = (lines + threads - 1) / threads * 16;
+
+    for (int t = 0; t < threads; ++t) {
+        data[t].start_k = t * slice;
+        data[t].end_k = (t * slice + slice - 1 < result_len - 1) ? t * slice + slice - 1 : result_len - 1;
+        data[t].threads = threads;
+        data[t].locals = locals;
+        data[t].result = result;
+
+        if (data[t].end_k >= data[t].start_k) {
+            if (pthread_create(&thread_ids[t], NULL, reduce_slice_worker, &data[t]) != 0) {
+                perror("pthread_create");
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    for (int t = 0; t < threads; ++t) {
+        if (data[t].end_k >= data[t].start_k) {
+            pthread_join(thread_ids[t], NULL);
+        }
+    }
+}
+
+// Each thread accumulates its range of poly1 into a private buffer with the given worker,
+// and the buffers are summed after the join.
+void run_private_case(int *poly1, int degree1, int *poly2, int degree2, int *baseline, int threads,
+                      void *(*worker)(void *), const char *label)
 {
     int result_len = degree1 + degree2 + 1;
     double start = now_seconds();
@@ -133,7 +192,7 @@ void run_parallel_case(int *poly1, int degree1, int *poly2, int degree2, int *ba
         data[t].result_local = locals[t];
 
         if (count > 0) {
-            if (pthread_create(&thread_ids[t], NULL, multiply_parallel_worker, &data[t]) != 0) {
+            if (pthread_create(&thread_ids[t], NULL, worker, &data[t]) != 0) {
                 perror("pthread_create");
                 exit(EXIT_FAILURE);
             }
@@ -151,62 +210,347 @@ void run_parallel_case(int *poly1, int degree1, int *poly2, int degree2, int *ba
         }
     }
 
+    double compute_end = now_seconds();
+
     int *result_parallel = (int *)calloc((size_t)result_len, sizeof(int));
     if (!result_parallel) {
         perror("calloc result_parallel");
         exit(EXIT_FAILURE);
     }
 
-    for (int t = 0; t < threads; ++t) {
-        for (int k = 0; k < result_len; ++k) {
-            result_parallel[k] += locals[t][k];
+    if (parallel_reduction) {
+        reduce_locals_parallel(locals, threads, result_len, result_parallel);
+    }
+    else {
+        for (int t = 0; t < threads; ++t) {
+            for (int k = 0; k < result_len; ++k) {
+                result_parallel[k] += locals[t][k];
+            }
         }
+    }
+    for (int t = 0; t < threads; ++t) {
         free(locals[t]);
     }
 
     double end = now_seconds();
 
-    printf("Parallel multiplication with %d threads took %.3f seconds\n", threads, end - start);
+    printf("%s multiplication with %d threads took %.3f seconds\n", label, threads, end - start);
+    printf("Compute phase: %.3f seconds, %s reduction: %.3f seconds\n",
+           compute_end - start, parallel_reduction ? "parallel" : "serial", end - compute_end);
+    printf("Match baseline: %s\n", results_equal(baseline, result_parallel, degree1 + degree2) ? "yes" : "no");
+    puts("---");
+
+    free(result_parallel);
+}
+
+void run_parallel_case(int *poly1, int degree1, int *poly2, int degree2, int *baseline, int threads)
+{
+    run_private_case(poly1, degree1, poly2, degree2, baseline, threads, multiply_parallel_worker, "Parallel");
+}
+
+void run_blocked_case(int *poly1, int degree1, int *poly2, int degree2, int *baseline, int threads)
+{
+    run_private_case(poly1, degree1, poly2, degree2, baseline, threads, multiply_blocked_worker, "Blocked");
+}
+
+// Each thread owns a contiguous range of output coefficients and writes them in place:
+// no private buffers and no reduction, so memory does not grow with the thread count.
+void run_partitioned_case(int *poly1, int degree1, int *poly2, int degree2, int *baseline, int threads)
+{
+    int result_len = degree1 + degree2 + 1;
+    double start = now_seconds();
+
+    pthread_t thread_ids[threads];
+    output_data_t data[threads];
+    int bounds[threads + 1];
+
+    int *result_parallel = (int *)malloc((size_t)result_len * sizeof(int));
+    if (!result_parallel) {
+        perror("malloc result_parallel");
+        exit(EXIT_FAILURE);
+    }
+
+    partition_outputs(degree1, degree2, threads, bounds);
+
+    for (int t = 0; t < threads; ++t) {
+        data[t].start_k = bounds[t];
+        data[t].end_k = bounds[t + 1] - 1;
+        data[t].degree1 = degree1;
+        data[t].degree2 = degree2;
+        data[t].poly1 = poly1;
+        data[t].poly2 = poly2;
+        data[t].result = result_parallel;
+
+        if (data[t].end_k >= data[t].start_k) {
+            if (pthread_create(&thread_ids[t], NULL, multiply_output_worker, &data[t]) != 0) {
+                perror("pthread_create");
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    for (int t = 0; t < threads; ++t) {
+        if (data[t].end_k >= data[t].start_k) {
+            pthread_join(thread_ids[t], NULL);
+        }
+    }
+
+    double end = now_seconds();
+
+    printf("Partitioned multiplication with %d threads took %.3f seconds\n", threads, end - start);
     printf("Match baseline: %s\n", results_equal(baseline, result_parallel, degree1 + degree2) ? "yes" : "no");
     puts("---");
 
     free(result_parallel);
 }
 
+void run_ntt_case(int *poly1, int degree1, int *poly2, int degree2, int *baseline, int threads)
+{
+    double start = now_seconds();
+    int *result_ntt = multiply_ntt(poly1, degree1, poly2, degree2, threads);
+    double end = now_seconds();
+
+    printf("NTT multiplication with %d threads took %.3f seconds\n", threads, end - start);
+    printf("Match baseline: %s\n", results_equal(baseline, result_ntt, degree1 + degree2) ? "yes" : "no");
+    puts("---");
+
+    free(result_ntt);
+}
+
+void *multiply_batch_worker(void *arg)
+{
+    batch_data_t *bd = (batch_data_t *)arg;
+    multiply_batch_range(bd->pairs, bd->first, bd->last, bd->arena, bd->offsets);
+    return NULL;
+}
+
+// -b mode: thousands of small products. Each thread takes a contiguous run of
+// whole lane groups and writes into one shared arena, so there is one spawn
+// per batch instead of one calloc and one spawn per product.
+void run_batch(int degree1, int degree2, int count, char **thread_args, int thread_argc)
+{
+    poly_pair_t *pairs = (poly_pair_t *)calloc((size_t)count, sizeof(poly_pair_t));
+    int **products = (int **)malloc((size_t)count * sizeof(int *));
+    size_t *offsets = (size_t *)malloc((size_t)count * sizeof(size_t));
+    if (!pairs || !products || !offsets) {
+        perror("malloc batch");
+        exit(EXIT_FAILURE);
+    }
+    for (int p = 0; p < count; ++p) {
+        pairs[p].poly1 = create_random_polynomial(degree1);
+        pairs[p].deg1 = degree1;
+        pairs[p].poly2 = create_random_polynomial(degree2);
+        pairs[p].deg2 = degree2;
+    }
+    size_t arena_len = batch_layout(pairs, count, offsets);
+    int *arena = (int *)malloc(arena_len * sizeof(int));
+    if (!arena) {
+        perror("malloc arena");
+        exit(EXIT_FAILURE);
+    }
+
+    double seq_start = now_seconds();
+    for (int p = 0; p < count; ++p) {
+        products[p] = multiply_sequential(pairs[p].poly1, degree1, pairs[p].poly2, degree2);
+    }
+    double seq_end = now_seconds();
+    printf("Sequential multiplication of %d pairs took %.3f seconds (%.0f products/s)\n",
+           count, seq_end - seq_start, count / (seq_end - seq_start));
+    puts("---");
+
+    int groups = (count + BATCH_LANES - 1) / BATCH_LANES;
+    for (int a = 0; a < thread_argc; ++a) {
+        int threads = atoi(thread_args[a]);
+        if (threads <= 0) {
+            fprintf(stderr, "Thread count must be positive (got %d).\n", threads);
+            continue;
+        }
+        pthread_t thread_ids[threads];
+        batch_data_t data[threads];
+
+        double start = now_seconds();
+        for (int t = 0; t < threads; ++t) {
+            data[t].pairs = pairs;
+            data[t].first = (int)((long)groups * t / threads) * BATCH_LANES;
+            data[t].last = (int)((long)groups * (t + 1) / threads) * BATCH_LANES;
+            if (data[t].last > count) {
+                data[t].last = count;
+            }
+            data[t].arena = arena;
+            data[t].offsets = offsets;
+            if (pthread_create(&thread_ids[t], NULL, multiply_batch_worker, &data[t]) != 0) {
+                perror("pthread_create");
+                exit(EXIT_FAILURE);
+            }
+        }
+        for (int t = 0; t < threads; ++t) {
+            pthread_join(thread_ids[t], NULL);
+        }
+        double end = now_seconds();
+
+        int match = 1;
+        for (int p = 0; p < count && match; ++p) {
+            match = results_equal(products[p], arena + offsets[p], degree1 + degree2);
+        }
+        printf("Batched multiplication of %d pairs with %d threads took %.3f seconds (%.0f products/s)\n",
+               count, threads, end - start, count / (end - start));
+        printf("Match baseline: %s\n", match ? "yes" : "no");
+        puts("---");
+    }
+
+    for (int p = 0; p < count; ++p) {
+        free((int *)pairs[p].poly1);
+        free((int *)pairs[p].poly2);
+        free(products[p]);
+    }
+    free(pairs);
+    free(products);
+    free(offsets);
+    free(arena);
+}
+
+// poly_multiply() picks the engine and thread count itself; threads is only an upper bound.
+void run_dispatch_case(int *poly1, int degree1, int *poly2, int degree2, int *baseline, int threads)
+{
+    poly_plan_t plan = poly_plan(degree1, degree2, threads);
+    double start = now_seconds();
+    int *result = poly_multiply_plan(poly1, degree1, poly2, degree2, plan);
+    double end = now_seconds();
+
+    printf("Dispatched multiplication with at most %d threads took %.3f seconds (%s, %d threads)\n",
+           threads, end - start, poly_engine_name(plan.engine), plan.threads);
+    printf("Match baseline: %s\n", results_equal(baseline, result, degree1 + degree2) ? "yes" : "no");
+    puts("---");
+
+    free(result);
+}
+
 int main(int argc, char *argv[])
 {
-    if (argc < 4) {
-        fprintf(stderr, "Usage: %s <degree1> <degree2> <threads...>\n", argv[0]);
+    const char *usage = "Usage: %s [-e schoolbook|blocked|partitioned|ntt|dispatch] [-r serial|parallel] [-b pairs] [--save file] {--load file | <degree1> <degree2>} <threads...>\n";
+    const char *engine = "schoolbook";
+    const char *load_path = NULL;
+    const char *save_path = NULL;
+    static const struct option long_options[] = {
+        {"load", required_argument, NULL, 'L'},
+        {"save", required_argument, NULL, 'S'},
+        {NULL, 0, NULL, 0}
+    };
+    int batch_pairs = 0;
+    void (*run_case)(int *, int, int *, int, int *, int) = NULL;
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "e:r:b:", long_options, NULL)) != -1) {
+        if (opt == 'L') {
+            load_path = optarg;
+        }
+        else if (opt == 'S') {
+            save_path = optarg;
+        }
+        else if (opt == 'e') {
+            engine = optarg;
+        }
+        else if (opt == 'b') {
+            batch_pairs = atoi(optarg);
+        }
+        else if (opt == 'r' && strcmp(optarg, "serial") == 0) {
+            parallel_reduction = 0;
+        }
+        else if (opt == 'r' && strcmp(optarg, "parallel") == 0) {
+            parallel_reduction = 1;
+        }
+        else {
+            fprintf(stderr, usage, argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (strcmp(engine, "schoolbook") == 0) {
+        run_case = run_parallel_case;
+    }
+    else if (strcmp(engine, "blocked") == 0) {
+        run_case = run_blocked_case;
+    }
+    else if (strcmp(engine, "partitioned") == 0) {
+        run_case = run_partitioned_case;
+    }
+    else if (strcmp(engine, "ntt") == 0) {
+        run_case = run_ntt_case;
+    }
+    else if (strcmp(engine, "dispatch") == 0) {
+        run_case = run_dispatch_case;
+    }
+    else {
+        fprintf(stderr, "Unknown engine '%s'.\n", engine);
+        fprintf(stderr, usage, argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    //--load takes the place of the two degrees
+    int first_thread = optind + (load_path ? 0 : 2);
+    if (argc - first_thread < 1 || (batch_pairs > 0 && (load_path || save_path))) {
+        fprintf(stderr, usage, argv[0]);
         return EXIT_FAILURE;
     }
 
-    int degree1 = atoi(argv[1]);
-    int degree2 = atoi(argv[2]);
+    int degree1 = load_path ? 0 : atoi(argv[optind]);
+    int degree2 = load_path ? 0 : atoi(argv[optind + 1]);
+
+    poly_seed(rng_default_seed());
 
-    srand(time(NULL));
+    if (batch_pairs > 0) {
+        run_batch(degree1, degree2, batch_pairs, argv + optind + 2, argc - optind - 2);
+        return EXIT_SUCCESS;
+    }
 
+    poly_file_t input = {0};
+    int *poly1, *poly2;
     double create_start = now_seconds();
-    int *poly1 = create_random_polynomial(degree1);
-    int *poly2 = create_random_polynomial(degree2);
+    if (load_path) {
+        poly_load_pair(load_path, &input, &poly1, &degree1, &poly2, &degree2);
+    }
+    else {
+        poly1 = create_random_polynomial(degree1);
+        poly2 = create_random_polynomial(degree2);
+    }
     double create_end = now_seconds();
-    printf("Generated polynomials in %.3f seconds\n", create_end - create_start);
+    printf("%s polynomials in %.3f seconds\n", load_path ? "Loaded" : "Generated", create_end - create_start);
+    if (save_path) {
+        poly_save_pair(save_path, poly1, degree1, poly2, degree2);
+    }
 
     double seq_start = now_seconds();
     int *baseline = multiply_sequential(poly1, degree1, poly2, degree2);
     double seq_end = now_seconds();
     printf("Sequential multiplication took %.3f seconds\n", seq_end - seq_start);
 
-    for (int arg = 3; arg < argc; ++arg) {
+    if (run_case == run_blocked_case) {
+        double blocked_start = now_seconds();
+        int *blocked = multiply_blocked(poly1, degree1, poly2, degree2);
+        double blocked_end = now_seconds();
+        printf("Blocked sequential multiplication took %.3f seconds (speedup over row loop: %.2fx)\n",
+               blocked_end - blocked_start, (seq_end - seq_start) / (blocked_end - blocked_start));
+        printf("Match baseline: %s\n", results_equal(baseline, blocked, degree1 + degree2) ? "yes" : "no");
+        puts("---");
+        free(blocked);
+    }
+
+    for (int arg = first_thread; arg < argc; ++arg) {
         int threads = atoi(argv[arg]);
         if (threads <= 0) {
             fprintf(stderr, "Thread count must be positive (got %d).\n", threads);
             continue;
         }
-        run_parallel_case(poly1, degree1, poly2, degree2, baseline, threads);
+        run_case(poly1, degree1, poly2, degree2, baseline, threads);
     }
 
-    free(poly1);
-    free(poly2);
+    if (load_path) {
+        poly_unload(&input);
+    }
+    else {
+        free(poly1);
+        free(poly2);
+    }
     free(baseline);
 
     return EXIT_SUCCESS;
@@ -5,12 +5,30 @@
 #include <pthread.h>
 #include <time.h>
 #include <stdatomic.h>
+#include <sched.h>
+
+#define CACHE_LINE 64
+#define READ_PERCENT 10             // default share of reads in the mixed workload
+#define SPIN_LIMIT 128              // spins before a waiter yields its core to the thread it waits for
+#define BACKOFF_MIN 4               // TTAS pause loop bounds after a failed exchange
+#define BACKOFF_MAX 4096
+
+// One counter per thread, each alone on its cache line: only the owner writes it, so an
+// increment is a plain load and store that never pulls the line away from another core.
+// Reading the total folds every shard, which is where the cost moves to.
+typedef struct {
+    _Alignas(CACHE_LINE) atomic_long count;
+} shard_t;
 
 int value;
 int iterations;
+int read_percent = READ_PERCENT;
 pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 pthread_rwlock_t rwlock = PTHREAD_RWLOCK_INITIALIZER;
 atomic_int value_atomic = 0;
+shard_t *shards;
+int num_shards;
+atomic_long read_sink = 0;          // sum of every value read, so the reads cannot be dropped
 
 void *worker_with_mutex(void *arg)
 {
@@ -43,66 +61,481 @@ void *worker_with_atomic(void *arg)
     return NULL;    
 }
 
-double now_seconds(void)
+long sharded_read(void)
 {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ts.tv_sec + ts.tv_nsec * 1e-9;
+    long total = 0;
+    for (int s = 0; s < num_shards; ++s) {
+        total += atomic_load_explicit(&shards[s].count, memory_order_relaxed);
+    }
+    return total;
 }
 
-// ./exercise2 <iterations> <threads>
-int main(int argc, char *argv[])            
+static inline void sharded_increment(shard_t *mine)
 {
-    if (argc != 3) {
-        fprintf(stderr, "Usage: %s <iterations> <num_threads>\n", argv[0]);
-        return EXIT_FAILURE;
-    }  
+    long v = atomic_load_explicit(&mine->count, memory_order_relaxed);
+    atomic_store_explicit(&mine->count, v + 1, memory_order_relaxed);
+}
 
-    iterations = atoi(argv[1]);
-    int num_threads = atoi(argv[2]);
+void *worker_with_shards(void *arg)
+{
+    shard_t *mine = &shards[*(int *)arg];
+    for (int i = 0; i < iterations; ++i) {
+        sharded_increment(mine);
+    }
+    return NULL;
+}
 
-    value = 0;
-    pthread_t threads[num_threads];
+// Mixed workload: read_percent of every hundred operations read the counter, the rest increment it.
+static inline int is_read(int i)
+{
+    return i % 100 < read_percent;
+}
 
+void *mixed_with_mutex(void *arg)
+{
+    (void)arg;
+    long seen = 0;
+    for (int i = 0; i < iterations; ++i) {
+        pthread_mutex_lock(&mutex);
+        if (is_read(i)) {
+            seen += value;
+        }
+        else {
+            value += 1;
+        }
+        pthread_mutex_unlock(&mutex);
+    }
+    atomic_fetch_add(&read_sink, seen);
+    return NULL;
+}
 
-    double start = now_seconds();
-    for (int i = 0; i < num_threads; ++i) {
-        pthread_create(&threads[i], NULL, worker_with_mutex, NULL);
+void *mixed_with_atomic(void *arg)
+{
+    (void)arg;
+    long seen = 0;
+    for (int i = 0; i < iterations; ++i) {
+        if (is_read(i)) {
+            seen += atomic_load(&value_atomic);
+        }
+        else {
+            atomic_fetch_add(&value_atomic, 1);
+        }
     }
+    atomic_fetch_add(&read_sink, seen);
+    return NULL;
+}
+
+void *mixed_with_shards(void *arg)
+{
+    shard_t *mine = &shards[*(int *)arg];
+    long seen = 0;
+    for (int i = 0; i < iterations; ++i) {
+        if (is_read(i)) {
+            seen += sharded_read();
+        }
+        else {
+            sharded_increment(mine);
+        }
+    }
+    atomic_fetch_add(&read_sink, seen);
+    return NULL;
+}
+
+// Pluggable lock interface for the lock suite. id is the calling thread's index, which the
+// queue locks use to find that thread's node.
+typedef struct {
+    const char *name;
+    void (*init)(int num_threads);
+    void (*lock)(int id);
+    void (*unlock)(int id);
+    void (*destroy)(void);
+} lock_ops_t;
+
+// Busy-wait step. Past SPIN_LIMIT spins the waiter yields, so with more threads than cores
+// the FIFO locks do not wait out whole time slices of a preempted predecessor.
+static inline void spin_pause(int *spins)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+    if (++*spins >= SPIN_LIMIT) {
+        *spins = 0;
+        sched_yield();
+    }
+}
+
+static void no_init(int num_threads) { (void)num_threads; }
+static void no_destroy(void) {}
+
+// pthread mutex through the same interface, as the reference point.
+static void pthread_lock(int id) { (void)id; pthread_mutex_lock(&mutex); }
+static void pthread_unlock(int id) { (void)id; pthread_mutex_unlock(&mutex); }
+
+// Test-and-test-and-set: spin reading the flag in cache, exchange only once it looks free,
+// and back off exponentially after losing a race so losers stop hammering the line.
+atomic_int ttas_flag = 0;
+
+static void ttas_lock(int id)
+{
+    (void)id;
+    int backoff = BACKOFF_MIN, spins = 0;
+    for (;;) {
+        while (atomic_load_explicit(&ttas_flag, memory_order_relaxed)) {
+            spin_pause(&spins);
+        }
+        if (!atomic_exchange_explicit(&ttas_flag, 1, memory_order_acquire)) {
+            return;
+        }
+        for (int i = 0; i < backoff; ++i) {
+            spin_pause(&spins);
+        }
+        backoff = backoff * 2 < BACKOFF_MAX ? backoff * 2 : BACKOFF_MAX;
+    }
+}
+
+static void ttas_unlock(int id)
+{
+    (void)id;
+    atomic_store_explicit(&ttas_flag, 0, memory_order_release);
+}
+
+// Ticket lock: FIFO by construction, but every waiter spins on the same serving counter.
+typedef struct {
+    _Alignas(CACHE_LINE) atomic_uint next;
+    _Alignas(CACHE_LINE) atomic_uint serving;
+} ticket_lock_t;
+
+ticket_lock_t ticket;
+
+static void ticket_init(int num_threads)
+{
+    (void)num_threads;
+    atomic_store(&ticket.next, 0);
+    atomic_store(&ticket.serving, 0);
+}
+
+static void ticket_lock(int id)
+{
+    (void)id;
+    int spins = 0;
+    unsigned mine = atomic_fetch_add_explicit(&ticket.next, 1, memory_order_relaxed);
+    while (atomic_load_explicit(&ticket.serving, memory_order_acquire) != mine) {
+        spin_pause(&spins);
+    }
+}
+
+static void ticket_unlock(int id)
+{
+    (void)id;
+    unsigned now = atomic_load_explicit(&ticket.serving, memory_order_relaxed);
+    atomic_store_explicit(&ticket.serving, now + 1, memory_order_release);
+}
+
+// MCS queue lock: each waiter spins on a flag in its own node, and the holder hands the
+// lock to its successor directly, so a release touches one other cache line.
+typedef struct mcs_node {
+    _Alignas(CACHE_LINE) struct mcs_node *_Atomic next;
+    atomic_int locked;
+} mcs_node_t;
+
+mcs_node_t *_Atomic mcs_tail;
+mcs_node_t *mcs_nodes;
+
+static void mcs_init(int num_threads)
+{
+    mcs_nodes = aligned_alloc(CACHE_LINE, (size_t)num_threads * sizeof(mcs_node_t));
+    if (!mcs_nodes) {
+        perror("aligned_alloc");
+        exit(EXIT_FAILURE);
+    }
+    atomic_store(&mcs_tail, NULL);
+}
+
+static void mcs_lock(int id)
+{
+    mcs_node_t *me = &mcs_nodes[id];
+    int spins = 0;
+    atomic_store_explicit(&me->next, NULL, memory_order_relaxed);
+    atomic_store_explicit(&me->locked, 1, memory_order_relaxed);
+    mcs_node_t *pred = atomic_exchange_explicit(&mcs_tail, me, memory_order_acq_rel);
+    if (pred) {
+        atomic_store_explicit(&pred->next, me, memory_order_release);
+        while (atomic_load_explicit(&me->locked, memory_order_acquire)) {
+            spin_pause(&spins);
+        }
+    }
+}
+
+static void mcs_unlock(int id)
+{
+    mcs_node_t *me = &mcs_nodes[id];
+    mcs_node_t *next = atomic_load_explicit(&me->next, memory_order_acquire);
+    if (!next) {
+        mcs_node_t *expected = me;
+        if (atomic_compare_exchange_strong_explicit(&mcs_tail, &expected, NULL,
+                                                    memory_order_release, memory_order_relaxed)) {
+            return;
+        }
+        // A successor swapped itself in but has not linked its node yet.
+        int spins = 0;
+        while (!(next = atomic_load_explicit(&me->next, memory_order_acquire))) {
+            spin_pause(&spins);
+        }
+    }
+    atomic_store_explicit(&next->locked, 0, memory_order_release);
+}
+
+static void mcs_destroy(void)
+{
+    free(mcs_nodes);
+}
 
+// CLH queue lock: each waiter spins on its predecessor's node and, on release, adopts that
+// node for its next acquisition, so nodes circulate and the queue needs no next pointers.
+typedef struct {
+    _Alignas(CACHE_LINE) atomic_int locked;
+} clh_node_t;
+
+typedef struct {
+    _Alignas(CACHE_LINE) clh_node_t *mine;
+    clh_node_t *pred;
+} clh_thread_t;
+
+clh_node_t *_Atomic clh_tail;
+clh_node_t *clh_pool;               // one node per thread plus the initial free one
+clh_thread_t *clh_threads;
+
+static void clh_init(int num_threads)
+{
+    clh_pool = aligned_alloc(CACHE_LINE, (size_t)(num_threads + 1) * sizeof(clh_node_t));
+    clh_threads = aligned_alloc(CACHE_LINE, (size_t)num_threads * sizeof(clh_thread_t));
+    if (!clh_pool || !clh_threads) {
+        perror("aligned_alloc");
+        exit(EXIT_FAILURE);
+    }
     for (int i = 0; i < num_threads; ++i) {
-        pthread_join(threads[i], NULL);
+        clh_threads[i].mine = &clh_pool[i];
     }
+    atomic_store(&clh_pool[num_threads].locked, 0);
+    atomic_store(&clh_tail, &clh_pool[num_threads]);
+}
 
-    double end = now_seconds();
-    printf("Final value calculated with mutex lock: %d\n", value);
-    printf("Elapsed time with mutex lock: %f seconds\n", end - start);
+static void clh_lock(int id)
+{
+    clh_thread_t *me = &clh_threads[id];
+    int spins = 0;
+    atomic_store_explicit(&me->mine->locked, 1, memory_order_relaxed);
+    me->pred = atomic_exchange_explicit(&clh_tail, me->mine, memory_order_acq_rel);
+    while (atomic_load_explicit(&me->pred->locked, memory_order_acquire)) {
+        spin_pause(&spins);
+    }
+}
 
-    value = 0;
-    start = now_seconds();
+static void clh_unlock(int id)
+{
+    clh_thread_t *me = &clh_threads[id];
+    clh_node_t *node = me->mine;
+    me->mine = me->pred;
+    atomic_store_explicit(&node->locked, 0, memory_order_release);
+}
+
+static void clh_destroy(void)
+{
+    free(clh_pool);
+    free(clh_threads);
+}
+
+const lock_ops_t lock_suite[] = {
+    {"pthread", no_init, pthread_lock, pthread_unlock, no_destroy},
+    {"ttas", no_init, ttas_lock, ttas_unlock, no_destroy},
+    {"ticket", ticket_init, ticket_lock, ticket_unlock, no_destroy},
+    {"mcs", mcs_init, mcs_lock, mcs_unlock, mcs_destroy},
+    {"clh", clh_init, clh_lock, clh_unlock, clh_destroy},
+};
+
+// Acquisitions per thread, each on its own line.
+typedef struct {
+    _Alignas(CACHE_LINE) long count;
+    double arrived;                 // when the thread reached suite_start
+} acquisitions_t;
+
+const lock_ops_t *suite_lock;
+acquisitions_t *acquisitions;
+int suite_total;
+pthread_barrier_t suite_start;      // no thread draws from the budget before all of them exist
+
+double now_seconds(void);
+
+// Same iterations x num_threads increments as worker_with_mutex, but drawn from one shared
+// budget: a thread keeps acquiring until the total is reached, so how the acquisitions
+// split between threads shows how fair the lock is.
+void *worker_with_lock(void *arg)
+{
+    int id = *(int *)arg;
+    long mine = 0;
+    acquisitions[id].arrived = now_seconds();
+    pthread_barrier_wait(&suite_start);
+    for (;;) {
+        suite_lock->lock(id);
+        if (value >= suite_total) {
+            suite_lock->unlock(id);
+            break;
+        }
+        value += 1;
+        suite_lock->unlock(id);
+        ++mine;
+    }
+    acquisitions[id].count = mine;
+    return NULL;
+}
+
+double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Starts num_threads copies of worker, thread i getting &ids[i], and returns the wall time until all have joined.
+double run_workers(void *(*worker)(void *), pthread_t *threads, int *ids, int num_threads)
+{
+    double start = now_seconds();
     for (int i = 0; i < num_threads; ++i) {
-        pthread_create(&threads[i], NULL, worker_with_rwlock, NULL);
+        pthread_create(&threads[i], NULL, worker, &ids[i]);
     }
 
     for (int i = 0; i < num_threads; ++i) {
         pthread_join(threads[i], NULL);
     }
-    end = now_seconds();
-    printf("Final value calculated with rwlock: %d\n", value);
-    printf("Elapsed time with rwlock: %f seconds\n", end - start);
+    return now_seconds() - start;
+}
 
-    value_atomic = 0;
-    start = now_seconds();
+// Like run_workers, for workers that wait on suite_start first: the clock starts when
+// the last of them arrives, since no acquisition can happen before that.
+double run_workers_together(void *(*worker)(void *), pthread_t *threads, int *ids, int num_threads)
+{
+    if (pthread_barrier_init(&suite_start, NULL, num_threads) != 0) {
+        perror("pthread_barrier_init");
+        exit(EXIT_FAILURE);
+    }
     for (int i = 0; i < num_threads; ++i) {
-        pthread_create(&threads[i], NULL, worker_with_atomic, NULL);
+        pthread_create(&threads[i], NULL, worker, &ids[i]);
     }
 
     for (int i = 0; i < num_threads; ++i) {
         pthread_join(threads[i], NULL);
     }
-    end = now_seconds();
+    double end = now_seconds(), start = acquisitions[0].arrived;
+    for (int i = 1; i < num_threads; ++i) {
+        if (acquisitions[i].arrived > start) start = acquisitions[i].arrived;
+    }
+    pthread_barrier_destroy(&suite_start);
+    return end - start;
+}
+
+void reset_shards(void)
+{
+    for (int s = 0; s < num_shards; ++s) {
+        atomic_store(&shards[s].count, 0);
+    }
+}
+
+// ./exercise2 <iterations> <threads> [read_percent]
+int main(int argc, char *argv[])
+{
+    if (argc != 3 && argc != 4) {
+        fprintf(stderr, "Usage: %s <iterations> <num_threads> [read_percent]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    iterations = atoi(argv[1]);
+    int num_threads = atoi(argv[2]);
+    if (argc == 4) {
+        read_percent = atoi(argv[3]);
+    }
+    if (num_threads < 1 || read_percent < 0 || read_percent > 100) {
+        fprintf(stderr, "Need at least one thread and a read percentage in [0, 100].\n");
+        return EXIT_FAILURE;
+    }
+
+    pthread_t threads[num_threads];
+    int ids[num_threads];
+    for (int i = 0; i < num_threads; ++i) {
+        ids[i] = i;
+    }
+    num_shards = num_threads;
+    shards = aligned_alloc(CACHE_LINE, (size_t)num_shards * sizeof(shard_t));
+    if (!shards) {
+        perror("aligned_alloc");
+        return EXIT_FAILURE;
+    }
+
+    value = 0;
+    double elapsed = run_workers(worker_with_mutex, threads, ids, num_threads);
+    printf("Final value calculated with mutex lock: %d\n", value);
+    printf("Elapsed time with mutex lock: %f seconds\n", elapsed);
+
+    value = 0;
+    elapsed = run_workers(worker_with_rwlock, threads, ids, num_threads);
+    printf("Final value calculated with rwlock: %d\n", value);
+    printf("Elapsed time with rwlock: %f seconds\n", elapsed);
+
+    value_atomic = 0;
+    elapsed = run_workers(worker_with_atomic, threads, ids, num_threads);
     printf("Final value calculated with atomic operations: %d\n", atomic_load(&value_atomic));
-    printf("Elapsed time with atomic operations: %f seconds\n", end - start);
+    printf("Elapsed time with atomic operations: %f seconds\n", elapsed);
 
+    reset_shards();
+    elapsed = run_workers(worker_with_shards, threads, ids, num_threads);
+    printf("Final value calculated with sharded counter: %ld\n", sharded_read());
+    printf("Elapsed time with sharded counter: %f seconds\n", elapsed);
+
+    printf("Mixed workload: %d%% reads of the whole counter, %d%% increments\n", read_percent, 100 - read_percent);
+    value = 0;
+    elapsed = run_workers(mixed_with_mutex, threads, ids, num_threads);
+    printf("Mixed final value with mutex lock: %d\n", value);
+    printf("Mixed elapsed time with mutex lock: %f seconds\n", elapsed);
+
+    value_atomic = 0;
+    elapsed = run_workers(mixed_with_atomic, threads, ids, num_threads);
+    printf("Mixed final value with atomic operations: %d\n", atomic_load(&value_atomic));
+    printf("Mixed elapsed time with atomic operations: %f seconds\n", elapsed);
+
+    reset_shards();
+    elapsed = run_workers(mixed_with_shards, threads, ids, num_threads);
+    printf("Mixed final value with sharded counter: %ld\n", sharded_read());
+    printf("Mixed elapsed time with sharded counter: %f seconds\n", elapsed);
+
+    // Lock suite: throughput, and fairness as the spread of per-thread acquisitions and
+    // Jain's index (1 when every thread got the same share, 1/num_threads when one got all).
+    acquisitions = aligned_alloc(CACHE_LINE, (size_t)num_threads * sizeof(acquisitions_t));
+    if (!acquisitions) {
+        perror("aligned_alloc");
+        return EXIT_FAILURE;
+    }
+    suite_total = iterations * num_threads;
+    for (size_t l = 0; l < sizeof(lock_suite) / sizeof(lock_suite[0]); ++l) {
+        suite_lock = &lock_suite[l];
+        suite_lock->init(num_threads);
+        value = 0;
+        elapsed = run_workers_together(worker_with_lock, threads, ids, num_threads);
+        suite_lock->destroy();
+
+        long min = acquisitions[0].count, max = acquisitions[0].count;
+        double sum = 0, sum_sq = 0;
+        for (int i = 0; i < num_threads; ++i) {
+            long c = acquisitions[i].count;
+            if (c < min) min = c;
+            if (c > max) max = c;
+            sum += c;
+            sum_sq += (double)c * c;
+        }
+        printf("Lock %s: %f seconds, %.2f M acquisitions/s, final value %d, per-thread min %ld max %ld, fairness %.3f\n",
+               suite_lock->name, elapsed, value / elapsed / 1e6, value, min, max,
+               sum_sq > 0 ? sum * sum / (num_threads * sum_sq) : 1.0);
+    }
+
+    free(acquisitions);
+    free(shards);
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -10,7 +10,8 @@ PROG="$ROOT_DIR/build/2.out"
 OUTPUT_FILE="$RESULTS_DIR/2c.txt"
 
 ITERATIONS=(100000 500000 1000000)
-THREADS=(2 4 6 8 10 12)
+THREADS=(2 4 6 8 10 12 16 32 64)
+LOCKS=(pthread ttas ticket mcs clh)
 REPEATS=4
 
 echo "--------Synchronization Benchmark--------" > "$OUTPUT_FILE"
@@ -28,6 +29,17 @@ for iter in "${ITERATIONS[@]}"; do
         mutex_sum=0
         rwlock_sum=0
         atomic_sum=0
+        sharded_sum=0
+        mixed_mutex_sum=0
+        mixed_atomic_sum=0
+        mixed_sharded_sum=0
+        declare -A lock_sum lock_min_sum lock_max_sum lock_fair_sum
+        for lock in "${LOCKS[@]}"; do
+            lock_sum[$lock]=0
+            lock_min_sum[$lock]=0
+            lock_max_sum[$lock]=0
+            lock_fair_sum[$lock]=0
+        done
 
         for ((run=1; run<=REPEATS; run++)); do
             echo "" | tee -a "$OUTPUT_FILE"
@@ -45,10 +57,27 @@ for iter in "${ITERATIONS[@]}"; do
             mutex_time=$(echo "$output" | grep "Elapsed time with mutex" | awk '{print $6}')
             rwlock_time=$(echo "$output" | grep "Elapsed time with rwlock" | awk '{print $5}')
             atomic_time=$(echo "$output" | grep "Elapsed time with atomic" | awk '{print $6}')
+            sharded_time=$(echo "$output" | grep "Elapsed time with sharded" | awk '{print $6}')
+            mixed_mutex_time=$(echo "$output" | grep "Mixed elapsed time with mutex" | awk '{print $7}')
+            mixed_atomic_time=$(echo "$output" | grep "Mixed elapsed time with atomic" | awk '{print $7}')
+            mixed_sharded_time=$(echo "$output" | grep "Mixed elapsed time with sharded" | awk '{print $7}')
 
             mutex_sum=$(echo "$mutex_sum + $mutex_time" | bc)
             rwlock_sum=$(echo "$rwlock_sum + $rwlock_time" | bc)
             atomic_sum=$(echo "$atomic_sum + $atomic_time" | bc)
+            sharded_sum=$(echo "$sharded_sum + $sharded_time" | bc)
+            mixed_mutex_sum=$(echo "$mixed_mutex_sum + $mixed_mutex_time" | bc)
+            mixed_atomic_sum=$(echo "$mixed_atomic_sum + $mixed_atomic_time" | bc)
+            mixed_sharded_sum=$(echo "$mixed_sharded_sum + $mixed_sharded_time" | bc)
+            for lock in "${LOCKS[@]}"; do
+                # time, per-thread min, per-thread max, fairness
+                read -r lock_time lock_min lock_max lock_fair <<< \
+                    "$(echo "$output" | grep "^Lock $lock:" | tr -d ',' | awk '{print $3, $13, $15, $17}')"
+                lock_sum[$lock]=$(echo "${lock_sum[$lock]} + $lock_time" | bc)
+                lock_min_sum[$lock]=$(echo "${lock_min_sum[$lock]} + $lock_min" | bc)
+                lock_max_sum[$lock]=$(echo "${lock_max_sum[$lock]} + $lock_max" | bc)
+                lock_fair_sum[$lock]=$(echo "${lock_fair_sum[$lock]} + $lock_fair" | bc)
+            done
         done
 
         echo "" | tee -a "$OUTPUT_FILE"
@@ -57,10 +86,27 @@ for iter in "${ITERATIONS[@]}"; do
         mutex_avg=$(echo "scale=6; $mutex_sum / $REPEATS" | bc)
         rwlock_avg=$(echo "scale=6; $rwlock_sum / $REPEATS" | bc)
         atomic_avg=$(echo "scale=6; $atomic_sum / $REPEATS" | bc)
+        sharded_avg=$(echo "scale=6; $sharded_sum / $REPEATS" | bc)
+        mixed_mutex_avg=$(echo "scale=6; $mixed_mutex_sum / $REPEATS" | bc)
+        mixed_atomic_avg=$(echo "scale=6; $mixed_atomic_sum / $REPEATS" | bc)
+        mixed_sharded_avg=$(echo "scale=6; $mixed_sharded_sum / $REPEATS" | bc)
 
         echo "Mutex average time:  $mutex_avg seconds" | tee -a "$OUTPUT_FILE"
         echo "RWLock average time: $rwlock_avg seconds" | tee -a "$OUTPUT_FILE"
         echo "Atomic average time: $atomic_avg seconds" | tee -a "$OUTPUT_FILE"
+        echo "Sharded average time: $sharded_avg seconds" | tee -a "$OUTPUT_FILE"
+        echo "Mixed mutex average time: $mixed_mutex_avg seconds" | tee -a "$OUTPUT_FILE"
+        echo "Mixed atomic average time: $mixed_atomic_avg seconds" | tee -a "$OUTPUT_FILE"
+        echo "Mixed sharded average time: $mixed_sharded_avg seconds" | tee -a "$OUTPUT_FILE"
+        for lock in "${LOCKS[@]}"; do
+            lock_avg=$(echo "scale=6; ${lock_sum[$lock]} / $REPEATS" | bc)
+            echo "Lock $lock average time: $lock_avg seconds" | tee -a "$OUTPUT_FILE"
+            lock_min_avg=$(echo "scale=1; ${lock_min_sum[$lock]} / $REPEATS" | bc)
+            lock_max_avg=$(echo "scale=1; ${lock_max_sum[$lock]} / $REPEATS" | bc)
+            lock_fair_avg=$(echo "scale=3; ${lock_fair_sum[$lock]} / $REPEATS" | bc)
+            echo "Lock $lock average acquisitions per thread: min $lock_min_avg max $lock_max_avg" | tee -a "$OUTPUT_FILE"
+            echo "Lock $lock average fairness: $lock_fair_avg" | tee -a "$OUTPUT_FILE"
+        done
         echo "" >> "$OUTPUT_FILE"
 
     done
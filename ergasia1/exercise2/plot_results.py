@@ -39,11 +39,29 @@ AVERAGE_PREFIXES: Tuple[LineHandler, ...] = (
     ("Mutex average time:", "Mutex"),
     ("RWLock average time:", "RWLock"),
     ("Atomic average time:", "Atomic"),
+    ("Sharded average time:", "Sharded"),
+    ("Mixed mutex average time:", "Mutex (mixed)"),
+    ("Mixed atomic average time:", "Atomic (mixed)"),
+    ("Mixed sharded average time:", "Sharded (mixed)"),
+    ("Lock pthread average time:", "Lock pthread"),
+    ("Lock ttas average time:", "Lock TTAS"),
+    ("Lock ticket average time:", "Lock ticket"),
+    ("Lock mcs average time:", "Lock MCS"),
+    ("Lock clh average time:", "Lock CLH"),
 )
 ELAPSED_PREFIXES: Tuple[LineHandler, ...] = (
     ("Elapsed time with mutex", "Mutex"),
     ("Elapsed time with rwlock", "RWLock"),
     ("Elapsed time with atomic", "Atomic"),
+    ("Elapsed time with sharded", "Sharded"),
+    ("Mixed elapsed time with mutex", "Mutex (mixed)"),
+    ("Mixed elapsed time with atomic", "Atomic (mixed)"),
+    ("Mixed elapsed time with sharded", "Sharded (mixed)"),
+    ("Lock pthread:", "Lock pthread"),
+    ("Lock ttas:", "Lock TTAS"),
+    ("Lock ticket:", "Lock ticket"),
+    ("Lock mcs:", "Lock MCS"),
+    ("Lock clh:", "Lock CLH"),
 )
 
 
@@ -124,7 +142,20 @@ def _finalize(
 
 def plot(data: BenchmarkData, output_dir: pathlib.Path) -> None:
     output_dir.mkdir(parents=True, exist_ok=True)
-    palette = {"Mutex": "tab:blue", "RWLock": "tab:orange", "Atomic": "tab:green"}
+    palette = {
+        "Mutex": "tab:blue",
+        "RWLock": "tab:orange",
+        "Atomic": "tab:green",
+        "Sharded": "tab:red",
+        "Mutex (mixed)": "tab:purple",
+        "Atomic (mixed)": "tab:olive",
+        "Sharded (mixed)": "tab:brown",
+        "Lock pthread": "tab:cyan",
+        "Lock TTAS": "tab:pink",
+        "Lock ticket": "tab:gray",
+        "Lock MCS": "black",
+        "Lock CLH": "gold",
+    }
 
     for iterations, methods in sorted(data.items()):
         plt.figure(figsize=(8, 5))
@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include "rng.h"
 
 struct array_stats_s {
     long long int info_array_0;
@@ -19,6 +20,12 @@ struct thread_args {
     long long int *stats;
 };
 
+struct generate_args {
+    int *array;
+    long long int size;
+    uint64_t stream;
+};
+
 double now_seconds()
 {
     struct timespec ts;
@@ -26,19 +33,16 @@ double now_seconds()
     return ts.tv_sec + ts.tv_nsec / 1e9;
 }
 
-int *generate_random_array(long long int size)
+//element i of the array on stream depends only on (stream, i), so the arrays are the
+//same whichever thread fills them, and $RNG_SEED reproduces a run exactly
+void *generate_random_array(void *arg)
 {
-    int *array = malloc(size * sizeof(int));
-    if (!array) {
-        perror("malloc");
-        exit(EXIT_FAILURE);
-    }
+    struct generate_args *g_args = arg;
 
-    for (long long int i = 0; i < size; i++) {
-        array[i] = rand() % 10;  //for random in [0, 9]
+    for (long long int i = 0; i < g_args->size; i++) {
+        g_args->array[i] = rng_int(g_args->stream, (uint64_t)i, 0, 9);  //for random in [0, 9]
     }
-
-    return array;
+    return NULL;
 }
 
 void *worker(void *arg)
@@ -96,18 +100,39 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
-    srand(time(NULL));
+    uint64_t seed = rng_default_seed();
+    int num_threads = 4;
+    pthread_t threads[num_threads];
 
+    int *generated[4];
+    struct generate_args gen_args[4];
+    for (int i = 0; i < 4; ++i) {
+        generated[i] = malloc(size * sizeof(int));
+        if (!generated[i]) {
+            perror("malloc");
+            exit(EXIT_FAILURE);
+        }
+        gen_args[i] = (struct generate_args){ generated[i], size, rng_stream(seed, i) };
+    }
+
+    //one generator thread per array
     double create_time = now_seconds();
-    int *array_1 = generate_random_array(size);
-    int *array_2 = generate_random_array(size);
-    int *array_3 = generate_random_array(size);
-    int *array_4 = generate_random_array(size);
+    for (int i = 0; i < num_threads; ++i) {
+        if (pthread_create(&threads[i], NULL, generate_random_array, (void *)&gen_args[i]) != 0) {
+            perror("pthread_create");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_join(threads[i], NULL);
+    }
     create_time = now_seconds() - create_time;
     printf("Arrays creation time: %.6f seconds\n", create_time);
 
-    int num_threads = 4;
-    pthread_t threads[num_threads];
+    int *array_1 = generated[0];
+    int *array_2 = generated[1];
+    int *array_3 = generated[2];
+    int *array_4 = generated[3];
     struct thread_args args[4];
 
     args[0] = (struct thread_args){ array_1, size, &array_stats.info_array_0 };
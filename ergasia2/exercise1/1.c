@@ -2,56 +2,82 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
 #include <omp.h>
-#include <time.h>
+#include "poly.h"
+#include "rng.h"
+#include "ntt.h"
+#include "sparse.h"
+#include "batch.h"
+#include "dispatch.h"
+#include "polyio.h"
+#include "incremental.h"
+#include "multipoint.h"
+#include "kernels.h"
 
-#define LOWER_BOUND -20
-#define UPPER_BOUND 20
+#define KARATSUBA_THRESHOLD 32      // Below this length fall back to schoolbook.
+#define UPDATE_ROUNDS 200           // -e update: batches applied per thread count.
 
-int *create_random_polynomial(int degree)
+int karatsuba_threshold = KARATSUBA_THRESHOLD;
+int parallel_reduction = 1;         // -r serial sums the private buffers on one thread instead.
+double density = 1.0;               // -d: fraction of coefficients drawn nonzero.
+int batch_pairs = 0;                // -b: multiply this many small pairs instead of one large pair.
+int update_batch = 1;               // -u: coefficients changed per batch in -e update.
+int tree_factors = 0;               // -m: multiply this many factors up a product tree instead of one pair.
+int eval_points = 0;                // -x: also evaluate the inputs and their product at this many points.
+
+//locals is a contiguous 2D buffer: locals[tid][k] at locals + tid*result_len + k.
+int *alloc_locals(int threads, int result_len)
 {
-    int *poly = (int *)malloc((size_t)(degree + 1) * sizeof(int));
-    if (!poly) {
-        perror("malloc");
+    int *locals = (int *)calloc((size_t)threads * (size_t)result_len, sizeof(int));
+    if (!locals) {
+        perror("calloc locals");
         exit(EXIT_FAILURE);
     }
-    for (int i = 0; i <= degree; ++i) {
-        poly[i] = (rand() % (UPPER_BOUND - LOWER_BOUND + 1)) + LOWER_BOUND;
-    }
-    return poly;
+    return locals;
 }
 
-int *multiply_sequential(const int *poly1, int deg1, const int *poly2, int deg2)
+//sums the per-thread buffers into a new result and frees them. The parallel version gives
+//each thread a slice of k and vectorises across k, reading every buffer once.
+int *reduce_locals(int *locals, int threads, int result_len)
 {
-    int result_len = deg1 + deg2 + 1;
-    int *result = (int *)calloc((size_t)result_len, sizeof(int));
-    if (!result) {
-        perror("calloc");
+    int *result_parallel = (int *)malloc((size_t)result_len * sizeof(int));
+    if (!result_parallel) {
+        perror("malloc result_parallel");
+        free(locals);
         exit(EXIT_FAILURE);
     }
-    for (int i = 0; i <= deg1; ++i) {
-        for (int j = 0; j <= deg2; ++j) {
-            result[i + j] += poly1[i] * poly2[j];
+
+    if (parallel_reduction) {
+        #pragma omp parallel for simd num_threads(threads) schedule(static)
+        for (int k = 0; k < result_len; ++k) {
+            int sum = 0;
+            for (int t = 0; t < threads; ++t) {
+                sum += locals[(size_t)t * (size_t)result_len + k];
+            }
+            result_parallel[k] = sum;
         }
     }
-    return result;
-}
-
-int results_equal(const int *res1, const int *res2, int degree)
-{
-    for (int i = 0; i <= degree; ++i) {
-        if (res1[i] != res2[i]) {
-            return 0;
+    else {
+        memset(result_parallel, 0, (size_t)result_len * sizeof(int));
+        for (int t = 0; t < threads; ++t) {
+            int *local = locals + (size_t)t * (size_t)result_len;
+            for (int k = 0; k < result_len; ++k) {
+                result_parallel[k] += local[k];
+            }
         }
     }
-    return 1;
+
+    free(locals);
+    return result_parallel;
 }
 
-double now_seconds(void)
+void print_phases(double start, double compute_end, double end)
 {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ts.tv_sec + ts.tv_nsec * 1e-9;
+    printf("Compute phase: %.3f seconds, %s reduction: %.3f seconds\n",
+           compute_end - start, parallel_reduction ? "parallel" : "serial", end - compute_end);
 }
 
 void run_parallel(int *p1, int d1, int *p2, int d2, int threads, int *baseline)
@@ -59,12 +85,7 @@ void run_parallel(int *p1, int d1, int *p2, int d2, int threads, int *baseline)
     int result_len = d1 + d2 + 1;
     double start = now_seconds();
 
-    //locals is a contiguous 2D buffer: locals[tid][k] at locals + tid*result_len + k.
-    int *locals = (int *)calloc((size_t)threads * (size_t)result_len, sizeof(int));
-    if (!locals) {
-        perror("calloc locals");
-        exit(EXIT_FAILURE);
-    }
+    int *locals = alloc_locals(threads, result_len);
 
     #pragma omp parallel num_threads(threads)
     {
@@ -79,56 +100,499 @@ void run_parallel(int *p1, int d1, int *p2, int d2, int threads, int *baseline)
         }
     }
 
-    int *result_parallel = (int *)calloc((size_t)result_len, sizeof(int));
-    if (!result_parallel) {
-        perror("calloc result_parallel");
-        free(locals);
+    double compute_end = now_seconds();
+    int *result_parallel = reduce_locals(locals, threads, result_len);
+
+    double end = now_seconds();
+    printf("Parallel multiplication with %d threads took %.3f seconds\n", threads, end - start);
+    print_phases(start, compute_end, end);
+    printf("Match baseline: %s\n", results_equal(baseline, result_parallel, d1 + d2) ? "yes" : "no");
+    free(result_parallel);
+}
+
+void run_blocked(int *p1, int d1, int *p2, int d2, int threads, int *baseline)
+{
+    int result_len = d1 + d2 + 1;
+    int tiles = (d1 + TILE_I) / TILE_I;
+    double start = now_seconds();
+
+    int *locals = alloc_locals(threads, result_len);
+
+    //whole TILE_I row tiles are handed out, so each thread walks poly1 in contiguous tiles.
+    #pragma omp parallel num_threads(threads)
+    {
+        int *local = locals + (size_t)omp_get_thread_num() * (size_t)result_len;
+
+        #pragma omp for schedule(static)
+        for (int t = 0; t < tiles; ++t) {
+            int i_start = t * TILE_I;
+            int i_end = (i_start + TILE_I - 1 < d1) ? i_start + TILE_I - 1 : d1;
+            multiply_blocked_kernel(p1, i_start, i_end, p2, d2, local);
+        }
+    }
+
+    double compute_end = now_seconds();
+    int *result_parallel = reduce_locals(locals, threads, result_len);
+
+    double end = now_seconds();
+    printf("Blocked multiplication with %d threads took %.3f seconds\n", threads, end - start);
+    print_phases(start, compute_end, end);
+    printf("Match baseline: %s\n", results_equal(baseline, result_parallel, d1 + d2) ? "yes" : "no");
+    free(result_parallel);
+}
+
+// Each thread owns a contiguous range of output coefficients and writes them in place:
+// no private buffers and no reduction, so memory does not grow with the thread count.
+void run_partitioned(int *p1, int d1, int *p2, int d2, int threads, int *baseline)
+{
+    int result_len = d1 + d2 + 1;
+    double start = now_seconds();
+
+    int *result_parallel = (int *)malloc((size_t)result_len * sizeof(int));
+    int *bounds = (int *)malloc((size_t)(threads + 1) * sizeof(int));
+    if (!result_parallel || !bounds) {
+        perror("malloc result_parallel");
         exit(EXIT_FAILURE);
     }
+    partition_outputs(d1, d2, threads, bounds);
 
+    //one range per thread; the loop form still covers every range if the team comes up smaller.
+    #pragma omp parallel for num_threads(threads) schedule(static, 1)
     for (int t = 0; t < threads; ++t) {
-        int *local = locals + (size_t)t * (size_t)result_len;
-        for (int k = 0; k < result_len; ++k) {
-            result_parallel[k] += local[k];
+        int end_k = bounds[t + 1] - 1;
+
+        //walk the owned range in TILE_J windows so the result window stays cache resident.
+        for (int kb = bounds[t]; kb <= end_k; kb += TILE_J) {
+            int ke = (kb + TILE_J - 1 < end_k) ? kb + TILE_J - 1 : end_k;
+            multiply_output_range(p1, d1, p2, d2, kb, ke, result_parallel);
         }
     }
 
-    free(locals);
     double end = now_seconds();
-    printf("Parallel multiplication with %d threads took %.3f seconds\n", threads, end - start);
+    printf("Partitioned multiplication with %d threads took %.3f seconds\n", threads, end - start);
     printf("Match baseline: %s\n", results_equal(baseline, result_parallel, d1 + d2) ? "yes" : "no");
+    free(bounds);
     free(result_parallel);
 }
 
+void run_karatsuba(int *p1, int d1, int *p2, int d2, int threads, int *baseline)
+{
+    double start = now_seconds();
+    int *result = multiply_karatsuba(p1, d1, p2, d2, karatsuba_threshold, simd_kernel_scalar, threads);
+    double end = now_seconds();
+    printf("Karatsuba multiplication with %d threads took %.3f seconds\n", threads, end - start);
+    printf("Match baseline: %s\n", results_equal(baseline, result, d1 + d2) ? "yes" : "no");
+    free(result);
+}
+
+void run_ntt(int *p1, int d1, int *p2, int d2, int threads, int *baseline)
+{
+    double start = now_seconds();
+    int *result = multiply_ntt(p1, d1, p2, d2, threads);
+    double end = now_seconds();
+    printf("NTT multiplication with %d threads took %.3f seconds\n", threads, end - start);
+    printf("Match baseline: %s\n", results_equal(baseline, result, d1 + d2) ? "yes" : "no");
+    free(result);
+}
+
+void run_sparse(int *p1, int d1, int *p2, int d2, int threads, int *baseline)
+{
+    double start = now_seconds();
+    sparse_poly_t s1 = sparse_from_dense(p1, d1);
+    sparse_poly_t s2 = sparse_from_dense(p2, d2);
+    double convert_end = now_seconds();
+    sparse_poly_t product = multiply_sparse(&s1, &s2, threads);
+    double end = now_seconds();
+    printf("Sparse multiplication with %d threads took %.3f seconds (%d x %d terms, conversion %.3f seconds)\n",
+           threads, end - start, s1.nnz, s2.nnz, convert_end - start);
+
+    int *result = sparse_to_dense(&product, d1 + d2);
+    printf("Match baseline: %s\n", results_equal(baseline, result, d1 + d2) ? "yes" : "no");
+    free(result);
+    sparse_free(&product);
+    sparse_free(&s1);
+    sparse_free(&s2);
+}
+
+// poly_multiply() picks the engine and thread count itself; threads is only an upper bound.
+void run_dispatch(int *p1, int d1, int *p2, int d2, int threads, int *baseline)
+{
+    poly_plan_t plan = poly_plan(d1, d2, threads);
+    double start = now_seconds();
+    int *result = poly_multiply_plan(p1, d1, p2, d2, plan);
+    double end = now_seconds();
+    printf("Dispatched multiplication with at most %d threads took %.3f seconds (%s, %d threads)\n",
+           threads, end - start, poly_engine_name(plan.engine), plan.threads);
+    printf("Match baseline: %s\n", results_equal(baseline, result, d1 + d2) ? "yes" : "no");
+    free(result);
+}
+
+// Density check: hash the nonzero term pairs when there are few enough of
+// them, otherwise let the dense dispatcher choose.
+void run_auto(int *p1, int d1, int *p2, int d2, int threads, int *baseline)
+{
+    if (sparse_preferred(count_nonzero(p1, d1), d1, count_nonzero(p2, d2), d2)) {
+        run_sparse(p1, d1, p2, d2, threads, baseline);
+    }
+    else {
+        run_dispatch(p1, d1, p2, d2, threads, baseline);
+    }
+}
+
+// -b mode: thousands of small products, where a calloc and a thread team
+// per product would cost more than the multiplication itself.
+void run_batch(int d1, int d2, int count, char **thread_args, int thread_argc)
+{
+    poly_pair_t *pairs = (poly_pair_t *)calloc((size_t)count, sizeof(poly_pair_t));
+    int **products = (int **)malloc((size_t)count * sizeof(int *));
+    size_t *offsets = (size_t *)malloc((size_t)count * sizeof(size_t));
+    if (!pairs || !products || !offsets) {
+        perror("malloc batch");
+        exit(EXIT_FAILURE);
+    }
+    for (int p = 0; p < count; ++p) {
+        pairs[p].poly1 = create_sparse_polynomial(d1, density);
+        pairs[p].deg1 = d1;
+        pairs[p].poly2 = create_sparse_polynomial(d2, density);
+        pairs[p].deg2 = d2;
+    }
+    size_t arena_len = batch_layout(pairs, count, offsets);
+    int *arena = (int *)malloc(arena_len * sizeof(int));
+    if (!arena) {
+        perror("malloc arena");
+        exit(EXIT_FAILURE);
+    }
+
+    double seq_start = now_seconds();
+    for (int p = 0; p < count; ++p) {
+        products[p] = multiply_sequential(pairs[p].poly1, d1, pairs[p].poly2, d2);
+    }
+    double seq_end = now_seconds();
+    printf("Sequential multiplication of %d pairs took %.3f seconds (%.0f products/s)\n",
+           count, seq_end - seq_start, count / (seq_end - seq_start));
+
+    for (int a = 0; a < thread_argc; ++a) {
+        int threads = atoi(thread_args[a]);
+        double start = now_seconds();
+        multiply_batch(pairs, count, arena, offsets, threads);
+        double end = now_seconds();
+        printf("Batched multiplication of %d pairs with %d threads took %.3f seconds (%.0f products/s)\n",
+               count, threads, end - start, count / (end - start));
+
+        int match = 1;
+        for (int p = 0; p < count && match; ++p) {
+            match = results_equal(products[p], arena + offsets[p], d1 + d2);
+        }
+        printf("Match baseline: %s\n", match ? "yes" : "no");
+    }
+
+    for (int p = 0; p < count; ++p) {
+        free((int *)pairs[p].poly1);
+        free((int *)pairs[p].poly2);
+        free(products[p]);
+    }
+    free(pairs);
+    free(products);
+    free(offsets);
+    free(arena);
+}
+
+// -e update: keeps the product alive through UPDATE_ROUNDS batches of update_batch
+// coefficient changes, alternating between poly1 and poly2, then checks it against a
+// fresh multiply of the updated factors.
+void run_update(int *p1, int d1, int *p2, int d2, int threads, int *baseline)
+{
+    int total = UPDATE_ROUNDS * update_batch;
+    poly_update_t *updates = (poly_update_t *)malloc((size_t)total * sizeof(poly_update_t));
+    if (!updates) {
+        perror("malloc updates");
+        exit(EXIT_FAILURE);
+    }
+    uint64_t stream = poly_next_stream();
+    for (int u = 0; u < total; ++u) {
+        int deg = (u / update_batch) % 2 == 0 ? d1 : d2;
+        updates[u].index = rng_int(stream, 2 * (uint64_t)u, 0, deg);
+        updates[u].value = rng_int(stream, 2 * (uint64_t)u + 1, LOWER_BOUND, UPPER_BOUND);
+    }
+
+    poly_live_t live;
+    poly_live_init(&live, p1, d1, p2, d2, baseline, threads);
+    double start = now_seconds();
+    for (int r = 0; r < UPDATE_ROUNDS; ++r) {
+        poly_live_update(&live, 1 + r % 2, updates + (size_t)r * update_batch, update_batch);
+    }
+    double end = now_seconds();
+
+    double full_start = now_seconds();
+    int *fresh = poly_multiply_threads(live.poly1, d1, live.poly2, d2, threads);
+    double full_end = now_seconds();
+    printf("Incremental updates, %d coefficients per batch, %d threads: %.3f ms per batch (full multiply %.3f ms)\n",
+           update_batch, threads, 1e3 * (end - start) / UPDATE_ROUNDS, 1e3 * (full_end - full_start));
+    printf("Match recomputed product: %s\n", results_equal(fresh, live.product, d1 + d2) ? "yes" : "no");
+
+    free(fresh);
+    free(updates);
+    poly_live_free(&live);
+}
+
+// -m mode: tree_factors polynomials, alternately of degree d1 and d2, multiplied up a
+// product tree and checked against a left-to-right sequential fold.
+void run_product_tree(int d1, int d2, int count, char **thread_args, int thread_argc)
+{
+    int **factors = (int **)malloc((size_t)count * sizeof(int *));
+    int *degrees = (int *)malloc((size_t)count * sizeof(int));
+    if (!factors || !degrees) {
+        perror("malloc factors");
+        exit(EXIT_FAILURE);
+    }
+    for (int f = 0; f < count; ++f) {
+        degrees[f] = f % 2 == 0 ? d1 : d2;
+        factors[f] = create_sparse_polynomial(degrees[f], density);
+    }
+
+    double seq_start = now_seconds();
+    int fold_deg = degrees[0];
+    int *fold = multiply_sequential(factors[0], degrees[0], (int[]){1}, 0);
+    for (int f = 1; f < count; ++f) {
+        int *next = multiply_sequential(fold, fold_deg, factors[f], degrees[f]);
+        free(fold);
+        fold = next;
+        fold_deg += degrees[f];
+    }
+    double seq_end = now_seconds();
+    printf("Sequential fold of %d factors took %.3f seconds (degree %d)\n", count, seq_end - seq_start, fold_deg);
+
+    for (int a = 0; a < thread_argc; ++a) {
+        int threads = atoi(thread_args[a]);
+        int degree;
+        double start = now_seconds();
+        int *product = poly_product_tree(factors, degrees, count, &degree, threads);
+        double end = now_seconds();
+        printf("Product tree of %d factors with %d threads took %.3f seconds\n", count, threads, end - start);
+        printf("Match baseline: %s\n", degree == fold_deg && results_equal(fold, product, degree) ? "yes" : "no");
+        free(product);
+    }
+
+    for (int f = 0; f < count; ++f) {
+        free(factors[f]);
+    }
+    free(factors);
+    free(degrees);
+    free(fold);
+}
+
+// -x: Horner at eval_points points for the product, and for both inputs to check it,
+// since the product's value at x must equal poly1(x) * poly2(x).
+void run_eval(int *p1, int d1, int *p2, int d2, int *baseline, const int *points, int threads)
+{
+    int *values = (int *)malloc((size_t)eval_points * 3 * sizeof(int));
+    if (!values) {
+        perror("malloc values");
+        exit(EXIT_FAILURE);
+    }
+    int *v1 = values + eval_points, *v2 = values + 2 * (size_t)eval_points;
+    double start = now_seconds();
+    poly_eval_points(baseline, d1 + d2, points, eval_points, values, threads);
+    double end = now_seconds();
+    poly_eval_points(p1, d1, points, eval_points, v1, threads);
+    poly_eval_points(p2, d2, points, eval_points, v2, threads);
+
+    int match = 1;
+    for (int p = 0; p < eval_points && match; ++p) {
+        match = (uint32_t)values[p] == (uint32_t)v1[p] * (uint32_t)v2[p];
+    }
+    printf("Horner evaluation of the product at %d points with %d threads took %.3f seconds (%.2f G terms/s)\n",
+           eval_points, threads, end - start, (double)eval_points * (d1 + d2 + 1) / (end - start) / 1e9);
+    printf("Match poly1(x) * poly2(x): %s\n", match ? "yes" : "no");
+    free(values);
+}
+
+void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-e schoolbook|blocked|partitioned|karatsuba|ntt|sparse|dispatch|auto|update] [-k threshold] [-r serial|parallel] [-d density] [-b pairs] [-m factors] [-u batch] [-x points] [--save file] {--load file | <degree1> <degree2>} <threads...>\n", prog);
+}
+
 int main(int argc, char *argv[]) 
 {
-    if (argc < 4) {
-        fprintf(stderr, "Usage: %s <degree1> <degree2> <threads...>\n", argv[0]);
+    const char *engine = "schoolbook";
+    const char *load_path = NULL;
+    const char *save_path = NULL;
+    static const struct option long_options[] = {
+        {"load", required_argument, NULL, 'L'},
+        {"save", required_argument, NULL, 'S'},
+        {NULL, 0, NULL, 0}
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "e:k:r:d:b:u:m:x:", long_options, NULL)) != -1) {
+        switch (opt) {
+        case 'L':
+            load_path = optarg;
+            break;
+        case 'S':
+            save_path = optarg;
+            break;
+        case 'e':
+            engine = optarg;
+            break;
+        case 'k':
+            karatsuba_threshold = atoi(optarg);
+            break;
+        case 'd':
+            density = atof(optarg);
+            break;
+        case 'b':
+            batch_pairs = atoi(optarg);
+            break;
+        case 'u':
+            update_batch = atoi(optarg);
+            break;
+        case 'm':
+            tree_factors = atoi(optarg);
+            break;
+        case 'x':
+            eval_points = atoi(optarg);
+            break;
+        case 'r':
+            if (strcmp(optarg, "serial") == 0) {
+                parallel_reduction = 0;
+            }
+            else if (strcmp(optarg, "parallel") == 0) {
+                parallel_reduction = 1;
+            }
+            else {
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    // --load takes the place of the two degrees
+    int first_thread = optind + (load_path ? 0 : 2);
+    if (argc - first_thread < 1 || ((batch_pairs > 0 || tree_factors > 0) && (load_path || save_path))) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (karatsuba_threshold < 1) {
+        fprintf(stderr, "Karatsuba threshold must be positive (got %d).\n", karatsuba_threshold);
+        return EXIT_FAILURE;
+    }
+    if (update_batch < 1) {
+        fprintf(stderr, "Update batch must be positive (got %d).\n", update_batch);
+        return EXIT_FAILURE;
+    }
+    if (density <= 0.0 || density > 1.0) {
+        fprintf(stderr, "Density must be in (0, 1] (got %g).\n", density);
         return EXIT_FAILURE;
     }
-    int d1 = atoi(argv[1]);
-    int d2 = atoi(argv[2]);
 
-    srand(time(NULL));
+    void (*run)(int *, int, int *, int, int, int *) = NULL;
+    if (strcmp(engine, "schoolbook") == 0) {
+        run = run_parallel;
+    }
+    else if (strcmp(engine, "blocked") == 0) {
+        run = run_blocked;
+    }
+    else if (strcmp(engine, "partitioned") == 0) {
+        run = run_partitioned;
+    }
+    else if (strcmp(engine, "karatsuba") == 0) {
+        run = run_karatsuba;
+    }
+    else if (strcmp(engine, "ntt") == 0) {
+        run = run_ntt;
+    }
+    else if (strcmp(engine, "sparse") == 0) {
+        run = run_sparse;
+    }
+    else if (strcmp(engine, "dispatch") == 0) {
+        run = run_dispatch;
+    }
+    else if (strcmp(engine, "auto") == 0) {
+        run = run_auto;
+    }
+    else if (strcmp(engine, "update") == 0) {
+        run = run_update;
+    }
+    else {
+        fprintf(stderr, "Unknown engine '%s'.\n", engine);
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int d1 = load_path ? 0 : atoi(argv[optind]);
+    int d2 = load_path ? 0 : atoi(argv[optind + 1]);
 
+    poly_seed(rng_default_seed());
+
+    if (batch_pairs > 0) {
+        run_batch(d1, d2, batch_pairs, argv + optind + 2, argc - optind - 2);
+        return 0;
+    }
+    if (tree_factors > 0) {
+        run_product_tree(d1, d2, tree_factors, argv + optind + 2, argc - optind - 2);
+        return 0;
+    }
+
+    poly_file_t input = {0};
+    int *poly1, *poly2;
     double create_start = now_seconds();
-    int *poly1 = create_random_polynomial(d1);
-    int *poly2 = create_random_polynomial(d2);
+    if (load_path) {
+        poly_load_pair(load_path, &input, &poly1, &d1, &poly2, &d2);
+    }
+    else {
+        poly1 = create_sparse_polynomial(d1, density);
+        poly2 = create_sparse_polynomial(d2, density);
+    }
     double create_end = now_seconds();
-    printf("Generated polynomials in %.3f seconds\n", create_end - create_start);
+    printf("%s polynomials in %.3f seconds\n", load_path ? "Loaded" : "Generated", create_end - create_start);
+    if (save_path) {
+        poly_save_pair(save_path, poly1, d1, poly2, d2);
+    }
     
     double seq_start = now_seconds();
     int *baseline = multiply_sequential(poly1, d1, poly2, d2);
     double seq_end = now_seconds();
     printf("Sequential multiplication took %.3f seconds\n", seq_end - seq_start);
 
-    for (int i = 3; i < argc; ++i) {
+    if (run == run_blocked) {
+        double blocked_start = now_seconds();
+        int *blocked = multiply_blocked(poly1, d1, poly2, d2);
+        double blocked_end = now_seconds();
+        printf("Blocked sequential multiplication took %.3f seconds (speedup over row loop: %.2fx)\n",
+               blocked_end - blocked_start, (seq_end - seq_start) / (blocked_end - blocked_start));
+        printf("Match baseline: %s\n", results_equal(baseline, blocked, d1 + d2) ? "yes" : "no");
+        free(blocked);
+    }
+
+    int *points = NULL;
+    if (eval_points > 0) {
+        points = (int *)malloc((size_t)eval_points * sizeof(int));
+        if (!points) {
+            perror("malloc points");
+            exit(EXIT_FAILURE);
+        }
+        poly_fill_random(points, 0, eval_points, poly_next_stream());
+    }
+
+    for (int i = first_thread; i < argc; ++i) {
         int threads = atoi(argv[i]);
-        run_parallel(poly1, d1, poly2, d2, threads, baseline);
+        run(poly1, d1, poly2, d2, threads, baseline);
+        if (eval_points > 0) {
+            run_eval(poly1, d1, poly2, d2, baseline, points, threads);
+        }
     }
+    free(points);
 
-    free(poly1);
-    free(poly2);
+    if (load_path) {
+        poly_unload(&input);
+    }
+    else {
+        free(poly1);
+        free(poly2);
+    }
     free(baseline);
 
     return 0;
@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include <omp.h>
 #include <time.h>
+#include "rng.h"
 
 typedef struct {
     int *values;
@@ -19,34 +20,37 @@ double now_seconds(void)
     return ts.tv_sec + ts.tv_nsec * 1e-9;
 }
 
-int **create_sparse_array(int m, int n, double sparsity) 
+// Element (i, j) is drawn from counters 2(i n + j) (zero or not) and 2(i n + j) + 1 (value)
+// of the stream, so rows can be generated in parallel with the same result for any thread count.
+int **create_sparse_array(int m, int n, double sparsity, uint64_t stream) 
 {
     int **array = (int **)malloc(m *sizeof(int *));
     for (int i = 0; i < m; i++) {
         array[i] = (int *)malloc(n * sizeof(int));
     }
 
+    #pragma omp parallel for
     for (int i = 0; i < m; i++) {
         for (int j = 0; j < n; j++) {
+            uint64_t k = 2 * ((uint64_t)i * n + j);
 
-            double r = (double) rand() / RAND_MAX;
-
-            if (r < sparsity) { 
+            if (rng_unit(stream, k) < sparsity) { 
                 array[i][j] = 0;
             }
             else {
-                array[i][j] = rand() % 100; 
+                array[i][j] = rng_int(stream, k + 1, 0, 99); 
             }
         }
     }
     return array;
 }
 
-int *create_vector(int n) 
+int *create_vector(int n, uint64_t stream) 
 {
     int *vector = (int *)malloc(n * sizeof(int));
+    #pragma omp parallel for
     for (int i = 0; i < n; i++) {
-        vector[i] = rand() % 100;
+        vector[i] = rng_int(stream, i, 0, 99);
     }
     return vector; 
 }
@@ -254,11 +258,11 @@ int main(int argc, char *argv[])
     int iterations = atoi(argv[3]);
     int threads = atoi(argv[4]);
 
-    srand(time(NULL));
+    uint64_t seed = rng_default_seed();
     omp_set_num_threads(threads);
 
-    int **array = create_sparse_array(m, m, sparsity);
-    int *vector = create_vector(m);
+    int **array = create_sparse_array(m, m, sparsity, rng_stream(seed, 0));
+    int *vector = create_vector(m, rng_stream(seed, 1));
 
     double start = now_seconds();
     CSRMatrix csr = convert_to_csr(array, m, m);
@@ -3,6 +3,7 @@
 #include <stdbool.h>
 #include <string.h>
 #include <omp.h>
+#include "rng.h"
 
 // Merge 2 sorted parts of array A. 
 void merge(int* A, int start_l, int end_l, int end_r, int* temp) { 
@@ -91,9 +92,10 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    srand(2200195);
-    for(int i = 0; i < N; i++){    // Create "random" int array.
-        A[i] = rand();
+    uint64_t stream = rng_stream(2200195, 0);
+    #pragma omp parallel for num_threads(nThreads)
+    for(int i = 0; i < N; i++){    // Create "random" int array, same for any thread count.
+        A[i] = rng_int(stream, i, 0, RAND_MAX);
     }
 
     double start, end;
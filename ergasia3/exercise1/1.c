@@ -3,43 +3,87 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
-#include <time.h>
 #include <mpi.h>
+#include <omp.h>
 #include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include "poly.h"
+#include "rng.h"
+#include "ntt.h"
+#include "polyio.h"
+
+#define CHECK_POINTS 4          //odd points: any single wrong coefficient changes the value mod 2^32
+
+//malloc and calloc that abort the run on failure. A rank with an empty slice or band asks
+//for 0 bytes and still gets a pointer, so NULL always means out of memory.
+void *xmalloc(size_t bytes)
+{
+    void *p = malloc(bytes ? bytes : 1);
+    if (!p) {
+        perror("malloc");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    return p;
+}
 
-#define LOWER_BOUND -20
-#define UPPER_BOUND 20
+void *xcalloc(size_t count, size_t size)
+{
+    void *p = calloc(count ? count : 1, size);
+    if (!p) {
+        perror("calloc");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    return p;
+}
 
-int *create_random_polynomial(int degree)
+//coefficients [first, first + count) of the polynomial on stream, drawn locally with
+//the rank's -t threads (see poly_set_threads)
+int *generate_slice(int first, int count, uint64_t stream)
 {
-    int *poly = (int *)malloc((size_t)(degree + 1) * sizeof(int));
-    if (!poly) {
-        perror("malloc");
-        exit(EXIT_FAILURE);
+    int *slice = xmalloc((size_t)count * sizeof(int));
+    poly_fill_random(slice, first, count, stream);
+    return slice;
+}
+
+//value mod 2^32 at x of coefficients [first, first + count) of a polynomial
+uint32_t eval_slice(const int *slice, int first, int count, uint32_t x)
+{
+    uint32_t acc = 0;
+    for (int i = count - 1; i >= 0; --i) {
+        acc = acc * x + (uint32_t)slice[i];
     }
-    for (int i = 0; i <= degree; ++i) {
-        int r = (int)(rand() % (UPPER_BOUND - LOWER_BOUND + 1));
-        poly[i] = r + LOWER_BOUND;
+    uint32_t shift = 1;
+    for (uint32_t b = x; first > 0; first >>= 1, b *= b) {
+        if (first & 1) shift *= b;
     }
-    return poly;
+    return acc * shift;
 }
 
-int *multiply_sequential(const int *poly1, int deg1, const int *poly2, int deg2)
+//values at the points of a polynomial spread over the ranks, on every rank. Each rank passes
+//its coefficients [first, first + count), or count 0 for a copy another rank already counts.
+void eval_distributed(const int *slice, int first, int count, const uint32_t *points, uint32_t *values)
 {
-    int result_len = deg1 + deg2 + 1;
-    int *result = (int *)calloc((size_t)result_len, sizeof(int));
-    if (!result) {
-        perror("calloc");
-        exit(EXIT_FAILURE);
+    uint32_t mine[CHECK_POINTS];
+    for (int k = 0; k < CHECK_POINTS; ++k) {
+        mine[k] = count > 0 ? eval_slice(slice, first, count, points[k]) : 0;
     }
-    for (int i = 0; i <= deg1; ++i) {
-        int a = poly1[i];
-        int *res = result + i;
-        for (int j = 0; j <= deg2; ++j) {
-            res[j] += a * poly2[j];
-        }
+    MPI_Allreduce(mine, values, CHECK_POINTS, MPI_UINT32_T, MPI_SUM, MPI_COMM_WORLD);
+}
+
+//check without -c: c = a * b wraps like the int kernels, so c(x) = a(x) * b(x) mod 2^32 at
+//every point, and each rank only evaluates the parts it already holds
+int product_matches(const int *a, int a_first, int a_count, const int *b, int b_first, int b_count,
+                    const int *c, int c_first, int c_count, const uint32_t *points)
+{
+    uint32_t va[CHECK_POINTS], vb[CHECK_POINTS], vc[CHECK_POINTS];
+    eval_distributed(a, a_first, a_count, points, va);
+    eval_distributed(b, b_first, b_count, points, vb);
+    eval_distributed(c, c_first, c_count, points, vc);
+    for (int k = 0; k < CHECK_POINTS; ++k) {
+        if (va[k] * vb[k] != vc[k]) return 0;
     }
-    return result;
+    return 1;
 }
 
 void compute_local_slice(int n, int rank, int size, int *local_start, int *local_len)
@@ -47,6 +91,7 @@ void compute_local_slice(int n, int rank, int size, int *local_start, int *local
     int chunk_size = (n + 1 + size - 1) / size;
 
     *local_start = rank * chunk_size;
+    if (*local_start > n + 1) *local_start = n + 1;
     int end = *local_start + chunk_size;
     if (end > n + 1) end = n + 1;
 
@@ -55,24 +100,14 @@ void compute_local_slice(int n, int rank, int size, int *local_start, int *local
 
 void distribute_poly1(int *poly1, int n, int rank, int size, int local_start, int local_len, int **local_poly1)
 {
-    *local_poly1 = malloc((size_t)local_len * sizeof(int));
-    if (!*local_poly1) {
-        perror("malloc");
-        MPI_Finalize();
-        exit(EXIT_FAILURE);
-    }
+    *local_poly1 = xmalloc((size_t)local_len * sizeof(int));
 
     if (rank == 0) {
         memcpy(*local_poly1, poly1 + local_start, (size_t)local_len * sizeof(int));
 
-        int chunk_size = (n + 1 + size - 1) / size;
-
         for (int p = 1; p < size; ++p) {
-            int p_start = p * chunk_size;
-            int p_end = p_start + chunk_size;
-            if (p_end > n + 1) p_end = n + 1;
-
-            int p_len = p_end - p_start;
+            int p_start, p_len;
+            compute_local_slice(n, p, size, &p_start, &p_len);
             MPI_Send(poly1 + p_start, p_len, MPI_INT, p, 0, MPI_COMM_WORLD);
         }
     }
@@ -81,133 +116,886 @@ void distribute_poly1(int *poly1, int n, int rank, int size, int local_start, in
     }
 }   
 
-int *parallel_local_multiply(const int *local_poly1, int local_start, int local_len, const int *poly2, int n)
+//a slice [start, start + local_len) of poly1 times a block of degree deg2 only reaches
+//outputs [start, start + local_len + deg2), so the local result is stored as that band
+int band_length(int local_len, int deg2)
 {
-    int full_len = 2 * n + 1;
-    int *local_result = calloc((size_t)full_len, sizeof(int));
-    if (!local_result) {
-        perror("calloc");
-        MPI_Finalize();
-        exit(EXIT_FAILURE);
-    }
+    return local_len > 0 && deg2 >= 0 ? local_len + deg2 : 0;
+}
 
-    for (int i = 0; i < local_len; ++i) {
-        int a = local_poly1[i];
-        int *res = local_result + local_start + i;
-        for (int j = 0; j <= n; ++j) {
-            res[j] += a * poly2[j];
+//adds rows [first, first + rows) of local_poly1 times poly2 into the band.
+//-t threads: the rank's OpenMP threads split the touched outputs into contiguous ranges,
+//so each output is written by one thread only and no per-thread copies are needed. Only
+//the main thread calls MPI (MPI_THREAD_FUNNELED).
+void accumulate_rows(const int *local_poly1, int first, int rows, const int *poly2, int deg2, int *band, int threads)
+{
+    int span = band_length(rows, deg2);
+
+    #pragma omp parallel num_threads(threads) if(threads > 1)
+    {
+        int tid = omp_get_thread_num();
+        int team = omp_get_num_threads();
+        int k_start = (int)((long long)span * tid / team);
+        int k_end = (int)((long long)span * (tid + 1) / team);
+
+        for (int i = 0; i < rows; ++i) {
+            int a = local_poly1[first + i];
+            int j_lo = k_start - i > 0 ? k_start - i : 0;
+            int j_hi = k_end - i - 1 < deg2 ? k_end - i - 1 : deg2;
+            int *res = band + first + i;
+            for (int j = j_lo; j <= j_hi; ++j) {
+                res[j] += a * poly2[j];
+            }
         }
     }
+}
+
+int *alloc_band(int band_len)
+{
+    return xcalloc((size_t)band_len, sizeof(int));
+}
+
+int *parallel_local_multiply(const int *local_poly1, int local_len, const int *poly2, int deg2, int threads)
+{
+    int *local_result = alloc_band(band_length(local_len, deg2));
+    accumulate_rows(local_poly1, 0, local_len, poly2, deg2, local_result, threads);
     return local_result;
 }
 
+typedef struct {
+    double wait;        //blocked waiting for chunks (or, at rank 0, for the sends)
+    double compute;
+    double hidden;      //compute done while later chunks were still in flight
+} pipeline_stats_t;
+
+//-p chunk: rank 0 posts every slice as chunk-sized MPI_Isends, first chunk of every rank
+//before the second chunk of any, and each rank multiplies chunk c as soon as it arrives
+//while chunks c+1.. are still in flight. Rank 0 works through its own slice in the same
+//chunks and calls MPI_Testall between them so its sends keep progressing.
+int *pipelined_local_multiply(const int *poly1, int n, const int *poly2, int rank, int size,
+                              int local_start, int local_len, int chunk, int threads,
+                              int **local_poly1, pipeline_stats_t *stats)
+{
+    int *band = alloc_band(band_length(local_len, n));
+    *local_poly1 = xmalloc((size_t)local_len * sizeof(int));
+    stats->wait = stats->compute = stats->hidden = 0;
+
+    if (rank == 0) {
+        int max_chunks = (n + 1 + size - 1) / size / chunk + 1;
+        MPI_Request *reqs = xmalloc((size_t)size * max_chunks * sizeof(MPI_Request));
+        int nreqs = 0;
+        for (int c = 0; c < max_chunks; ++c) {
+            for (int p = 1; p < size; ++p) {
+                int p_start, p_len;
+                compute_local_slice(n, p, size, &p_start, &p_len);
+                if (c * chunk >= p_len) continue;
+                int len = p_len - c * chunk < chunk ? p_len - c * chunk : chunk;
+                MPI_Isend(poly1 + p_start + c * chunk, len, MPI_INT, p, c, MPI_COMM_WORLD, &reqs[nreqs++]);
+            }
+        }
+
+        memcpy(*local_poly1, poly1 + local_start, (size_t)local_len * sizeof(int));
+        int flag = nreqs == 0;
+        for (int first = 0; first < local_len; first += chunk) {
+            int rows = local_len - first < chunk ? local_len - first : chunk;
+            double t0 = MPI_Wtime();
+            accumulate_rows(*local_poly1, first, rows, poly2, n, band, threads);
+            double t1 = MPI_Wtime();
+            stats->compute += t1 - t0;
+            if (!flag) {
+                stats->hidden += t1 - t0;
+                MPI_Testall(nreqs, reqs, &flag, MPI_STATUSES_IGNORE);
+            }
+        }
+        double t0 = MPI_Wtime();
+        MPI_Waitall(nreqs, reqs, MPI_STATUSES_IGNORE);
+        stats->wait += MPI_Wtime() - t0;
+        free(reqs);
+        return band;
+    }
+
+    int nchunks = (local_len + chunk - 1) / chunk;
+    MPI_Request *reqs = xmalloc((size_t)nchunks * sizeof(MPI_Request));
+    for (int c = 0; c < nchunks; ++c) {
+        int len = local_len - c * chunk < chunk ? local_len - c * chunk : chunk;
+        MPI_Irecv(*local_poly1 + c * chunk, len, MPI_INT, 0, c, MPI_COMM_WORLD, &reqs[c]);
+    }
+    for (int c = 0; c < nchunks; ++c) {
+        double t0 = MPI_Wtime();
+        MPI_Wait(&reqs[c], MPI_STATUS_IGNORE);
+        double t1 = MPI_Wtime();
+        int rows = local_len - c * chunk < chunk ? local_len - c * chunk : chunk;
+        accumulate_rows(*local_poly1, c * chunk, rows, poly2, n, band, threads);
+        double t2 = MPI_Wtime();
+        stats->wait += t1 - t0;
+        stats->compute += t2 - t1;
+        if (c + 1 < nchunks) stats->hidden += t2 - t1;
+    }
+    free(reqs);
+    return band;
+}
+
 
-int *reduce_results(int *local_result, int n, int rank)
+//-r full: widen the band back to 2n+1 on every rank and reduce everything at rank 0
+int *reduce_results(const int *band, int band_start, int band_len, int n, int rank)
 {
     int full_len = 2 * n + 1;
     int *global_result = NULL;
+    int *local_result = xcalloc((size_t)full_len, sizeof(int));
+    memcpy(local_result + band_start, band, (size_t)band_len * sizeof(int));
 
     if (rank == 0) {
-        global_result = calloc((size_t)full_len, sizeof(int));
-        if (!global_result) {
-            perror("calloc");
-            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
-        }
+        global_result = xcalloc((size_t)full_len, sizeof(int));
     }
 
     MPI_Reduce(local_result, global_result, full_len, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
 
+    free(local_result);
     return global_result;
 }
 
-double now_seconds(void)
+//rank q owns outputs [owner_start(q), owner_start(q + 1)) of the 2n+1 result
+int owner_start(int q, int n, int size)
+{
+    return (int)((long long)(2 * n + 1) * q / size);
+}
+
+//overlap of [a_lo, a_hi) and [b_lo, b_hi), written to *lo, returned as a length >= 0
+int overlap(int a_lo, int a_hi, int b_lo, int b_hi, int *lo)
+{
+    *lo = a_lo > b_lo ? a_lo : b_lo;
+    int hi = a_hi < b_hi ? a_hi : b_hi;
+    return hi > *lo ? hi - *lo : 0;
+}
+
+//-r banded: reduce-scatter over the bands. Every rank sends each owner only the part
+//of its band inside that owner's range, the owners sum what they receive, and rank 0
+//gathers the summed ranges. No rank allocates or sends a full 2n+1 buffer except the
+//final result at rank 0. Bands may come from any decomposition; their extents are
+//exchanged first so every rank knows what it will receive.
+int *reduce_results_banded(const int *band, int band_start, int band_len, int n, int rank, int size)
+{
+    int full_len = 2 * n + 1;
+    int own_lo = owner_start(rank, n, size);
+    int own_len = owner_start(rank + 1, n, size) - own_lo;
+
+    int *counts = xmalloc((size_t)size * 8 * sizeof(int));
+    int *owned = xcalloc((size_t)own_len, sizeof(int));
+    int *send_counts = counts, *send_displs = counts + size;
+    int *recv_counts = counts + 2 * size, *recv_displs = counts + 3 * size;
+    int *recv_starts = counts + 4 * size, *gather_counts = counts + 5 * size;
+    int *extents = counts + 6 * size;
+
+    int extent[2] = {band_start, band_len};
+    MPI_Allgather(extent, 2, MPI_INT, extents, 2, MPI_INT, MPI_COMM_WORLD);
+
+    int recv_total = 0;
+    for (int q = 0; q < size; ++q) {
+        int lo;
+        int q_lo = owner_start(q, n, size), q_hi = owner_start(q + 1, n, size);
+        send_counts[q] = overlap(band_start, band_start + band_len, q_lo, q_hi, &lo);
+        send_displs[q] = send_counts[q] ? lo - band_start : 0;
+
+        int q_start = extents[2 * q], q_len = extents[2 * q + 1];
+        recv_counts[q] = overlap(q_start, q_start + q_len, own_lo, own_lo + own_len, &lo);
+        recv_starts[q] = lo - own_lo;
+        recv_displs[q] = recv_total;
+        recv_total += recv_counts[q];
+        gather_counts[q] = q_hi - q_lo;
+    }
+
+    int *recv = xmalloc((size_t)recv_total * sizeof(int));
+    MPI_Alltoallv(band, send_counts, send_displs, MPI_INT,
+                  recv, recv_counts, recv_displs, MPI_INT, MPI_COMM_WORLD);
+
+    for (int p = 0; p < size; ++p) {
+        int *dst = owned + recv_starts[p];
+        const int *src = recv + recv_displs[p];
+        for (int k = 0; k < recv_counts[p]; ++k) {
+            dst[k] += src[k];
+        }
+    }
+    free(recv);
+
+    int *global_result = NULL;
+    if (rank == 0) {
+        global_result = xmalloc((size_t)full_len * sizeof(int));
+        for (int q = 0; q < size; ++q) {
+            recv_displs[q] = owner_start(q, n, size);
+        }
+    }
+    MPI_Gatherv(owned, own_len, MPI_INT, global_result, gather_counts, recv_displs, MPI_INT, 0, MPI_COMM_WORLD);
+
+    free(owned);
+    free(counts);
+    return global_result;
+}
+
+//even split of len coefficients into parts blocks, block idx is [*start, *start + *block_len)
+void block_range(int len, int parts, int idx, int *start, int *block_len)
+{
+    *start = (int)((long long)len * idx / parts);
+    *block_len = (int)((long long)len * (idx + 1) / parts) - *start;
+}
+
+//rows x cols process grid, as square as size allows (rows <= cols)
+void grid_shape(int size, int *rows, int *cols)
+{
+    *rows = 1;
+    for (int r = 1; r * r <= size; ++r) {
+        if (size % r == 0) *rows = r;
+    }
+    *cols = size / *rows;
+}
+
+//-d 2d: rank (r, c) of the grid owns block r of poly1 and block c of poly2. Rank 0 scatters
+//the poly1 blocks down grid column 0 and the poly2 blocks along grid row 0, then each row
+//broadcasts its poly1 block and each column its poly2 block, so every rank receives
+//O(n / sqrt(p)) coefficients instead of all of poly2.
+void distribute_2d(const int *poly1, const int *poly2, int n, int rows, int cols, int rank,
+                   int **block1, int *start1, int *len1, int **block2, int *start2, int *len2)
+{
+    int r = rank / cols, c = rank % cols;
+    MPI_Comm row_comm, col_comm;
+    MPI_Comm_split(MPI_COMM_WORLD, r, c, &row_comm);
+    MPI_Comm_split(MPI_COMM_WORLD, c, r, &col_comm);
+
+    block_range(n + 1, rows, r, start1, len1);
+    block_range(n + 1, cols, c, start2, len2);
+    *block1 = xmalloc((size_t)*len1 * sizeof(int));
+    *block2 = xmalloc((size_t)*len2 * sizeof(int));
+    int *counts = xmalloc((size_t)(rows + cols) * 2 * sizeof(int));
+    int *counts1 = counts, *displs1 = counts + rows;
+    int *counts2 = counts + 2 * rows, *displs2 = counts + 2 * rows + cols;
+    for (int q = 0; q < rows; ++q) block_range(n + 1, rows, q, &displs1[q], &counts1[q]);
+    for (int q = 0; q < cols; ++q) block_range(n + 1, cols, q, &displs2[q], &counts2[q]);
+
+    if (c == 0) {
+        MPI_Scatterv(poly1, counts1, displs1, MPI_INT, *block1, *len1, MPI_INT, 0, col_comm);
+    }
+    if (r == 0) {
+        MPI_Scatterv(poly2, counts2, displs2, MPI_INT, *block2, *len2, MPI_INT, 0, row_comm);
+    }
+    MPI_Bcast(*block1, *len1, MPI_INT, 0, row_comm);
+    MPI_Bcast(*block2, *len2, MPI_INT, 0, col_comm);
+
+    free(counts);
+    MPI_Comm_free(&row_comm);
+    MPI_Comm_free(&col_comm);
+}
+
+//-e ntt: six-step transform. The zero-padded length-N input is viewed as an N1 x N2 matrix,
+//coefficient N2 * n1 + n2 at row n1, column n2, and every rank owns a block of rows, i.e. a
+//contiguous slice of coefficients. Length-N1 transforms run down the columns, then a twiddle
+//w_N^(n2 k1), then length-N2 transforms along the rows; each switch between row and column
+//ownership is one MPI_Alltoallv transpose. The spectrum is left in that transposed,
+//bit-reversed order since the pointwise product and the inverse do not care.
+typedef struct {
+    int log_n, log1, log2;      //N = 2^log_n = N1 * N2
+    int nprimes;
+    int local_max;              //most transform values any rank holds per plane
+    double transpose;           //slowest rank's time in the all-to-all transposes
+} ntt_info_t;
+
+//rows x cols matrix distributed by row blocks (local (r - r0) * cols + c) into its transpose
+//distributed the same way (local (c - c0) * rows + r), for planes separate arrays at once
+void transpose_blocks(const uint32_t *src, uint32_t *dst, int planes, int rows, int cols, int rank, int size)
+{
+    int r0, nr, c0, nc;
+    block_range(rows, size, rank, &r0, &nr);
+    block_range(cols, size, rank, &c0, &nc);
+    size_t in = (size_t)nr * cols, out = (size_t)nc * rows;
+
+    int *counts = xmalloc((size_t)size * 4 * sizeof(int));
+    uint32_t *send = xmalloc(in * planes * sizeof(uint32_t));
+    uint32_t *recv = xmalloc(out * planes * sizeof(uint32_t));
+    int *send_counts = counts, *send_displs = counts + size;
+    int *recv_counts = counts + 2 * size, *recv_displs = counts + 3 * size;
+
+    size_t k = 0;
+    for (int q = 0; q < size; ++q) {
+        int q0, qn;
+        block_range(cols, size, q, &q0, &qn);
+        send_displs[q] = (int)k;
+        for (int c = q0; c < q0 + qn; ++c) {
+            for (int r = 0; r < nr; ++r) {
+                for (int pl = 0; pl < planes; ++pl) {
+                    send[k++] = src[pl * in + (size_t)r * cols + c];
+                }
+            }
+        }
+        send_counts[q] = (int)k - send_displs[q];
+
+        block_range(rows, size, q, &q0, &qn);
+        recv_counts[q] = qn * nc * planes;
+        recv_displs[q] = q == 0 ? 0 : recv_displs[q - 1] + recv_counts[q - 1];
+    }
+
+    MPI_Alltoallv(send, send_counts, send_displs, MPI_UINT32_T,
+                  recv, recv_counts, recv_displs, MPI_UINT32_T, MPI_COMM_WORLD);
+
+    for (int q = 0; q < size; ++q) {
+        int q0, qn;
+        block_range(rows, size, q, &q0, &qn);
+        const uint32_t *from = recv + recv_displs[q];
+        for (int c = 0; c < nc; ++c) {
+            for (int r = q0; r < q0 + qn; ++r) {
+                for (int pl = 0; pl < planes; ++pl) {
+                    dst[pl * out + (size_t)c * rows + r] = *from++;
+                }
+            }
+        }
+    }
+
+    free(send);
+    free(recv);
+    free(counts);
+}
+
+//multiplies column c0 + j (length N1, bit-reversed k1 order) by w^(n2 k1), n2 = c0 + j
+void twiddle_columns(uint32_t *a, int n1_len, int c0, int nc, const int *rev, uint32_t w, int k, int threads)
+{
+    #pragma omp parallel for schedule(static) num_threads(threads)
+    for (int j = 0; j < nc; ++j) {
+        ntt_twiddle(a + (size_t)j * n1_len, n1_len, rev, ntt_pow(k, w, (uint64_t)(c0 + j)), k);
+    }
+}
+
+//multiplies row i0 + i (length N2, natural n2 order, holding k1 = rev[i0 + i]) by w^(n2 k1)
+void twiddle_rows(uint32_t *a, int n2_len, int i0, int ni, const int *rev, uint32_t w, int k, int threads)
+{
+    #pragma omp parallel for schedule(static) num_threads(threads)
+    for (int i = 0; i < ni; ++i) {
+        ntt_twiddle(a + (size_t)i * n2_len, n2_len, NULL, ntt_pow(k, w, (uint64_t)rev[i0 + i]), k);
+    }
+}
+
+//slice1/slice2 hold coefficients [lo, lo + count) of the two degree-n inputs, where
+//[lo, lo + count) is this rank's row block clamped to n + 1. Returns the product
+//coefficients of the same row block, clamped to 2n + 1, in *res_len values.
+int *distributed_ntt_multiply(const int *slice1, const int *slice2, int lo, int count, int n,
+                              int rank, int size, int threads, ntt_info_t *info, int *res_len)
+{
+    int log_n = info->log_n, log1 = info->log1, log2 = info->log2;
+    int N1 = 1 << log1, N2 = 1 << log2;
+    int r0, nr, c0, nc;
+    block_range(N1, size, rank, &r0, &nr);
+    block_range(N2, size, rank, &c0, &nc);
+    size_t rows_len = (size_t)nr * N2, cols_len = (size_t)nc * N1;
+    size_t cap = rows_len > cols_len ? rows_len : cols_len;
+
+    //global bound on the coefficients decides whether a third prime is needed
+    uint64_t local_max[2] = {0, 0}, global_max[2];
+    for (int i = 0; i < count; ++i) {
+        uint64_t a = (uint64_t)llabs(slice1[i]), b = (uint64_t)llabs(slice2[i]);
+        if (a > local_max[0]) local_max[0] = a;
+        if (b > local_max[1]) local_max[1] = b;
+    }
+    MPI_Allreduce(local_max, global_max, 2, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+    int nprimes = ntt_primes_needed(global_max[0], global_max[1], n + 1);
+    info->nprimes = nprimes;
+
+    //plane 2k + 0 / 2k + 1: poly1 / poly2 modulo prime k
+    int planes = 2 * nprimes;
+    uint32_t *a = xmalloc(cap * planes * sizeof(uint32_t));
+    uint32_t *b = xmalloc(cap * planes * sizeof(uint32_t));
+    uint32_t *roots = xmalloc((size_t)N2 * sizeof(uint32_t));
+    int *rev = xmalloc((size_t)N1 * sizeof(int));
+    rev[0] = 0;
+    for (int i = 1; i < N1; ++i) {
+        rev[i] = (rev[i >> 1] >> 1) | ((i & 1) << (log1 - 1));
+    }
+
+    for (int k = 0; k < nprimes; ++k) {
+        uint32_t p = ntt_prime(k);
+        #pragma omp parallel for schedule(static) num_threads(threads)
+        for (size_t i = 0; i < rows_len; ++i) {
+            long long g = (long long)r0 * N2 + (long long)i - lo;
+            int in = g >= 0 && g < count;
+            int64_t v1 = in ? slice1[g] % (int64_t)p : 0, v2 = in ? slice2[g] % (int64_t)p : 0;
+            a[2 * k * rows_len + i] = (uint32_t)(v1 < 0 ? v1 + p : v1);
+            a[(2 * k + 1) * rows_len + i] = (uint32_t)(v2 < 0 ? v2 + p : v2);
+        }
+    }
+
+    double t_transpose = 0, t0 = MPI_Wtime();
+    transpose_blocks(a, b, planes, N1, N2, rank, size);
+    t_transpose += MPI_Wtime() - t0;
+
+    for (int k = 0; k < nprimes; ++k) {
+        ntt_roots(roots, log1, k, 0, threads);
+        for (int pl = 2 * k; pl < 2 * k + 2; ++pl) {
+            ntt_forward_batch(b + pl * cols_len, N1, nc, roots, k, threads);
+            twiddle_columns(b + pl * cols_len, N1, c0, nc, rev, ntt_root(k, log_n, 0), k, threads);
+        }
+    }
+
+    t0 = MPI_Wtime();
+    transpose_blocks(b, a, planes, N2, N1, rank, size);
+    t_transpose += MPI_Wtime() - t0;
+
+    //forward rows, pointwise product scaled by 1/N into plane k, inverse rows
+    for (int k = 0; k < nprimes; ++k) {
+        uint32_t *fa = a + 2 * k * rows_len, *fb = a + (2 * k + 1) * rows_len, *prod = b + k * rows_len;
+        ntt_roots(roots, log2, k, 0, threads);
+        ntt_forward_batch(fa, N2, nr, roots, k, threads);
+        ntt_forward_batch(fb, N2, nr, roots, k, threads);
+        ntt_pointwise(prod, fa, fb, rows_len, log_n, k, threads);
+        ntt_roots(roots, log2, k, 1, threads);
+        ntt_inverse_batch(prod, N2, nr, roots, k, threads);
+        twiddle_rows(prod, N2, r0, nr, rev, ntt_root(k, log_n, 1), k, threads);
+    }
+
+    t0 = MPI_Wtime();
+    transpose_blocks(b, a, nprimes, N1, N2, rank, size);
+    t_transpose += MPI_Wtime() - t0;
+
+    for (int k = 0; k < nprimes; ++k) {
+        ntt_roots(roots, log1, k, 1, threads);
+        ntt_inverse_batch(a + k * cols_len, N1, nc, roots, k, threads);
+    }
+
+    t0 = MPI_Wtime();
+    transpose_blocks(a, b, nprimes, N2, N1, rank, size);
+    t_transpose += MPI_Wtime() - t0;
+
+    //back to row block r0: natural coefficients [r0 * N2, (r0 + nr) * N2)
+    long long first = (long long)r0 * N2, last = first + (long long)rows_len;
+    if (last > 2LL * n + 1) last = 2LL * n + 1;
+    *res_len = last > first ? (int)(last - first) : 0;
+    int *result = xmalloc((size_t)*res_len * sizeof(int));
+    #pragma omp parallel for schedule(static) num_threads(threads)
+    for (int i = 0; i < *res_len; ++i) {
+        uint32_t residues[NTT_MAX_PRIMES];
+        for (int k = 0; k < nprimes; ++k) residues[k] = b[k * rows_len + i];
+        result[i] = ntt_crt(residues, nprimes);
+    }
+
+    int local = (int)cap;
+    MPI_Reduce(&local, &info->local_max, 1, MPI_INT, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&t_transpose, &info->transpose, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    free(a);
+    free(b);
+    free(roots);
+    free(rev);
+    return result;
+}
+
+//the ranks' row blocks as coefficient ranges of a length-len polynomial
+void ntt_slice(int len, int log2, int log1, int q, int size, int *lo, int *count)
 {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ts.tv_sec + ts.tv_nsec * 1e-9;
+    int r0, nr;
+    block_range(1 << log1, size, q, &r0, &nr);
+    long long first = (long long)r0 << log2, last = (long long)(r0 + nr) << log2;
+    if (first > len) first = len;
+    if (last > len) last = len;
+    *lo = (int)first;
+    *count = (int)(last - first);
+}
+
+//-e ntt driver: draw (or scatter) the row-block slices and multiply. The product stays
+//distributed and is checked at the points, unless -c gathers it on rank 0 for a full check.
+void run_ntt(const int *poly1, const int *poly2, const int *baseline, int n, int rank, int size, int threads,
+             int local_gen, uint64_t stream1, uint64_t stream2, int check_full, const uint32_t *points)
+{
+    ntt_info_t info = {0};
+    while ((1L << info.log_n) < 2L * n + 1) {
+        ++info.log_n;
+    }
+    if (info.log_n > NTT_MAX_LOG) {
+        if (rank == 0) fprintf(stderr, "-e ntt: product length %d exceeds 2^%d\n", 2 * n + 1, NTT_MAX_LOG);
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    info.log1 = info.log_n / 2;
+    info.log2 = info.log_n - info.log1;
+
+    int *counts = xmalloc((size_t)size * 4 * sizeof(int));
+    int *in_counts = counts, *in_displs = counts + size;
+    int *out_counts = counts + 2 * size, *out_displs = counts + 3 * size;
+    for (int q = 0; q < size; ++q) {
+        ntt_slice(n + 1, info.log2, info.log1, q, size, &in_displs[q], &in_counts[q]);
+        ntt_slice(2 * n + 1, info.log2, info.log1, q, size, &out_displs[q], &out_counts[q]);
+    }
+    int lo = in_displs[rank], count = in_counts[rank];
+
+    //-g local: drawn before the clock starts, as in the schoolbook path
+    int *slice1 = NULL, *slice2 = NULL;
+    double gen_time = 0;
+    if (local_gen) {
+        double t_gen_start = MPI_Wtime();
+        slice1 = generate_slice(lo, count, stream1);
+        slice2 = generate_slice(lo, count, stream2);
+        gen_time = MPI_Wtime() - t_gen_start;
+    }
+
+    double t_total_start = MPI_Wtime();
+    if (!local_gen) {
+        slice1 = xmalloc((size_t)count * sizeof(int));
+        slice2 = xmalloc((size_t)count * sizeof(int));
+        MPI_Scatterv(poly1, in_counts, in_displs, MPI_INT, slice1, count, MPI_INT, 0, MPI_COMM_WORLD);
+        MPI_Scatterv(poly2, in_counts, in_displs, MPI_INT, slice2, count, MPI_INT, 0, MPI_COMM_WORLD);
+    }
+    double t_send_end = MPI_Wtime();
+
+    int res_len;
+    int *local_result = distributed_ntt_multiply(slice1, slice2, lo, count, n, rank, size, threads, &info, &res_len);
+    double t_comp_end = MPI_Wtime();
+
+    int *global_result = NULL;
+    if (check_full) {
+        if (rank == 0) {
+            global_result = xmalloc((size_t)(2 * n + 1) * sizeof(int));
+        }
+        MPI_Gatherv(local_result, res_len, MPI_INT, global_result, out_counts, out_displs, MPI_INT, 0, MPI_COMM_WORLD);
+    }
+    double t_total_end = MPI_Wtime();
+
+    double gen_max = 0;
+    if (local_gen) MPI_Reduce(&gen_time, &gen_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    int match = check_full ? rank == 0 && results_equal(baseline, global_result, 2 * n)
+                           : product_matches(slice1, lo, count, slice2, lo, count,
+                                             local_result, out_displs[rank], res_len, points);
+
+    if (rank == 0) {
+        printf("Layout: %d ranks x %d threads (%d cores)\n", size, threads, size * threads);
+        if (local_gen) {
+            printf("Time to generate slices: %.6f s\n", gen_max);
+        }
+        printf("Time to send slices: %.6f s\n", t_send_end - t_total_start);
+        printf("Parallel computation: %.6f s\n", t_comp_end - t_send_end);
+        printf("Distributed NTT: N = 2^%d (%d x %d), %d primes, transposes %.6f s, at most %d values per plane per rank\n",
+               info.log_n, 1 << info.log1, 1 << info.log2, info.nprimes, info.transpose, info.local_max);
+        if (check_full) {
+            printf("Time to gather results: %.6f s\n", t_total_end - t_comp_end);
+        }
+        printf("Total parallel: %.6f s\n", t_total_end - t_total_start);
+        printf("Engine: ntt, %s: %s\n", check_full ? "match sequential" : "match at random points", match ? "yes" : "no");
+    }
+
+    free(global_result);
+    free(local_result);
+    free(slice1);
+    free(slice2);
+    free(counts);
 }
 
 int main(int argc, char *argv[]) 
 {
-    MPI_Init(&argc, &argv);
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
 
     int rank, size;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
-    if (argc < 2) {
-        if (rank == 0) fprintf(stderr, "Usage: %s <degree>\n", argv[0]);
+    const char *usage = "Usage: %s [-r banded|full] [-d 1d|2d] [-t threads_per_rank] [-p chunk] [-e schoolbook|ntt] [-g local|root] [-c] [--save file] {--load file | <degree>}\n";
+    int banded = 1;
+    int decomp_2d = 0;
+    int threads = 1;
+    int chunk = 0;
+    int use_ntt = 0;
+    int local_gen = 1;
+    int check_full = 0;
+    const char *load_path = NULL;
+    const char *save_path = NULL;
+    static const struct option long_options[] = {
+        {"load", required_argument, NULL, 'L'},
+        {"save", required_argument, NULL, 'S'},
+        {NULL, 0, NULL, 0}
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "r:d:t:p:e:g:c", long_options, NULL)) != -1) {
+        if (opt == 'L') {
+            load_path = optarg;
+        }
+        else if (opt == 'S') {
+            save_path = optarg;
+        }
+        else if (opt == 't' && atoi(optarg) > 0) {
+            threads = atoi(optarg);
+        }
+        else if (opt == 'c') {
+            check_full = 1;
+        }
+        else if (opt == 'p' && atoi(optarg) >= 0) {
+            chunk = atoi(optarg);
+        }
+        else if (opt == 'g' && strcmp(optarg, "local") == 0) {
+            local_gen = 1;
+        }
+        else if (opt == 'g' && strcmp(optarg, "root") == 0) {
+            local_gen = 0;
+        }
+        else if (opt == 'e' && strcmp(optarg, "schoolbook") == 0) {
+            use_ntt = 0;
+        }
+        else if (opt == 'e' && strcmp(optarg, "ntt") == 0) {
+            use_ntt = 1;
+        }
+        else if (opt == 'd' && strcmp(optarg, "1d") == 0) {
+            decomp_2d = 0;
+        }
+        else if (opt == 'd' && strcmp(optarg, "2d") == 0) {
+            decomp_2d = 1;
+        }
+        else if (opt == 'r' && strcmp(optarg, "banded") == 0) {
+            banded = 1;
+        }
+        else if (opt == 'r' && strcmp(optarg, "full") == 0) {
+            banded = 0;
+        }
+        else {
+            if (rank == 0) fprintf(stderr, usage, argv[0]);
+            MPI_Finalize();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!load_path && argc - optind < 1) {
+        if (rank == 0) fprintf(stderr, usage, argv[0]);
         MPI_Finalize();
         return EXIT_FAILURE;
     }
+    //-e ntt has its own row-block layout and full-length result, so the schoolbook layout options do not apply
+    if (use_ntt && (decomp_2d || !banded || chunk > 0)) {
+        if (rank == 0) {
+            fprintf(stderr, "-e ntt cannot be combined with -d 2d, -r full or -p.\n");
+            fprintf(stderr, usage, argv[0]);
+        }
+        MPI_Finalize();
+        return EXIT_FAILURE;
+    }
+
+    //--load: only rank 0 maps the file, the other ranks learn n from it (-1 if it failed)
+    poly_file_t input = {0};
+    int n = load_path ? -1 : atoi(argv[optind]);
+    if (load_path) {
+        if (rank == 0 && poly_load(load_path, &input) == 0) {
+            if (input.count < 2 || input.degrees[0] != input.degrees[1]) {
+                fprintf(stderr, "%s: needs two polynomials of equal degree\n", load_path);
+                poly_unload(&input);
+            }
+            else {
+                n = input.degrees[0];
+            }
+        }
+        MPI_Bcast(&n, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (n < 0) {
+            MPI_Finalize();
+            return EXIT_FAILURE;
+        }
+        if (local_gen && rank == 0) fprintf(stderr, "--load keeps the inputs on rank 0, using -g root.\n");
+        local_gen = 0;
+    }
+    if (threads > 1 && provided < MPI_THREAD_FUNNELED) {
+        if (rank == 0) fprintf(stderr, "MPI library lacks MPI_THREAD_FUNNELED, using 1 thread per rank.\n");
+        threads = 1;
+    }
+    //the generators honour -t too, so ranks sharing a node do not each take every core
+    poly_set_threads(threads);
+    if (decomp_2d && chunk > 0) {
+        if (rank == 0) fprintf(stderr, "-p only applies to the 1d schoolbook decomposition, ignoring it.\n");
+        chunk = 0;
+    }
+    if (chunk > 0 && local_gen) {
+        if (rank == 0) fprintf(stderr, "-p pipelines the transfer from rank 0, using -g root.\n");
+        local_gen = 0;
+    }
 
-    int n = atoi(argv[1]);
-    srand(time(NULL));
+    //-g local: every rank draws its own slices from the shared seed, so nothing has to be
+    //sent and rank 0 only builds the whole polynomials for -c or --save
+    uint64_t seed = rng_default_seed();
+    MPI_Bcast(&seed, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+    poly_seed(seed);
+    uint64_t stream1 = poly_next_stream();
+    uint64_t stream2 = poly_next_stream();
+    uint64_t check_stream = poly_next_stream();
+    uint32_t points[CHECK_POINTS];
+    for (int k = 0; k < CHECK_POINTS; ++k) {
+        points[k] = (uint32_t)rng_at(check_stream, k) | 1u;
+    }
 
     int *poly1 = NULL;
     int *poly2 = NULL;
 
     if (rank == 0) {
-        poly1 = create_random_polynomial(n);
-        poly2 = create_random_polynomial(n);
-    } 
-    else {
-        poly2 = malloc((size_t)(n + 1) * sizeof(int));
-        if (!poly2) { perror("malloc"); 
-            MPI_Finalize(); 
-            return EXIT_FAILURE; 
+        printf("Input generation: %s\n", local_gen ? "local (each rank draws its own slices)" : "root (rank 0 sends the slices)");
+        double t0 = now_seconds();
+        if (load_path) {
+            poly1 = input.polys[0];
+            poly2 = input.polys[1];
+        }
+        else if (!local_gen || check_full || save_path) {
+            poly1 = generate_slice(0, n + 1, stream1);
+            poly2 = generate_slice(0, n + 1, stream2);
         }
+        if (poly1) {
+            printf("%s polynomials in %.3f seconds\n", load_path ? "Loaded" : "Generated", now_seconds() - t0);
+        }
+        if (save_path && poly_save(save_path, 2, (int *const[]){poly1, poly2}, (const int[]){n, n}) != 0) {
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+    } 
+    else if (!decomp_2d && !use_ntt && !local_gen) {
+        poly2 = xmalloc((size_t)(n + 1) * sizeof(int));
     }
 
-    //sequential multiplication 
-    if (rank == 0) {
+    //-c: sequential multiplication, by single-process NTT for -e ntt where schoolbook would dominate
+    int *baseline = NULL;
+    if (rank == 0 && check_full) {
         double t0 = now_seconds();
-        int *tmp = multiply_sequential(poly1, n, poly2, n);
+        baseline = use_ntt ? multiply_ntt(poly1, n, poly2, n, 1) : multiply_sequential(poly1, n, poly2, n);
         double t1 = now_seconds();
         printf("Sequential time: %.6f seconds\n", t1 - t0);
-        free(tmp);
     }
 
-    double t_total_start = MPI_Wtime();
-    double t_send_start = MPI_Wtime();
-
-    //broadcast poly2 to all processes
-    MPI_Bcast(poly2, n + 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (use_ntt) {
+        run_ntt(poly1, poly2, baseline, n, rank, size, threads, local_gen, stream1, stream2, check_full, points);
+        free(baseline);
+        if (load_path) {
+            poly_unload(&input);
+        }
+        else if (rank == 0) {
+            free(poly1);
+            free(poly2);
+        }
+        MPI_Finalize();
+        return 0;
+    }
 
-    //determine local slice for each process
     int local_start, local_len;
-    compute_local_slice(n, rank, size, &local_start, &local_len);
-
     int *local_poly1 = NULL;
-    distribute_poly1(poly1, n, rank, size, local_start, local_len, &local_poly1);
+    int local_start2 = 0, local_len2 = n + 1;
+    int *local_poly2 = NULL;
+    int rows = size, cols = 1;
+    int *local_result = NULL;
+    pipeline_stats_t stats;
+    double overlap_pct = 0;
+
+    if (decomp_2d) {
+        grid_shape(size, &rows, &cols);
+    }
+    else {
+        //determine local slice for each process
+        compute_local_slice(n, rank, size, &local_start, &local_len);
+    }
 
-    double t_send_end = MPI_Wtime();
+    //-g local: the slices are drawn before the clock starts, so the send time only covers
+    //communication; generation is reported on its own line
+    double gen_time = 0;
+    if (local_gen) {
+        double t_gen_start = MPI_Wtime();
+        if (decomp_2d) {
+            block_range(n + 1, rows, rank / cols, &local_start, &local_len);
+            block_range(n + 1, cols, rank % cols, &local_start2, &local_len2);
+            local_poly1 = generate_slice(local_start, local_len, stream1);
+            local_poly2 = generate_slice(local_start2, local_len2, stream2);
+        }
+        else {
+            if (!poly2) poly2 = generate_slice(0, n + 1, stream2);
+            local_poly1 = generate_slice(local_start, local_len, stream1);
+        }
+        gen_time = MPI_Wtime() - t_gen_start;
+    }
 
+    double t_total_start = MPI_Wtime();
+    double t_send_start = MPI_Wtime();
 
-    //parallel local multiplication
-    double t_comp_start = MPI_Wtime();
-    int *local_result = parallel_local_multiply(local_poly1, local_start, local_len, poly2, n);
-    double t_comp_end = MPI_Wtime();
+    if (!local_gen && decomp_2d) {
+        distribute_2d(poly1, poly2, n, rows, cols, rank,
+                      &local_poly1, &local_start, &local_len, &local_poly2, &local_start2, &local_len2);
+    }
+    else if (!local_gen) {
+        //broadcast poly2 to all processes
+        MPI_Bcast(poly2, n + 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+        if (chunk > 0) {
+            local_result = pipelined_local_multiply(poly1, n, poly2, rank, size, local_start, local_len,
+                                                    chunk, threads, &local_poly1, &stats);
+        }
+        else {
+            distribute_poly1(poly1, n, rank, size, local_start, local_len, &local_poly1);
+        }
+    }
+
+    double t_send_end = MPI_Wtime();
+    double send_time = t_send_end - t_send_start;
+    double comp_time = 0;
+
+    if (chunk > 0) {
+        //distribution and computation interleave: report the slowest rank's waiting and
+        //computing separately, and how much of all compute ran while chunks were in flight
+        double mine[4] = {stats.wait, stats.compute, stats.hidden, stats.wait + stats.hidden};
+        double worst[4], total[4];
+        MPI_Reduce(mine, worst, 4, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        MPI_Reduce(mine, total, 4, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+        if (rank == 0) {
+            send_time = send_time - stats.compute - stats.wait + worst[0];
+            comp_time = worst[1];
+            overlap_pct = total[3] > 0 ? 100.0 * total[2] / total[3] : 0;
+        }
+    }
+    else {
+        //parallel local multiplication
+        double t_comp_start = MPI_Wtime();
+        local_result = parallel_local_multiply(local_poly1, local_len,
+                                               decomp_2d ? local_poly2 : poly2, local_len2 - 1, threads);
+        comp_time = MPI_Wtime() - t_comp_start;
+    }
+    int band_start = local_start + local_start2;
+    int band_len = band_length(local_len, local_len2 - 1);
 
     //reduce only relevant slice of results
     double t_recv_start = MPI_Wtime();
-    int *global_result = reduce_results(local_result, n, rank);
+    int *global_result = banded
+        ? reduce_results_banded(local_result, band_start, band_len, n, rank, size)
+        : reduce_results(local_result, band_start, band_len, n, rank);
     double t_recv_end = MPI_Wtime();
     
     double t_total_end = MPI_Wtime();
 
+    double gen_max = 0;
+    if (local_gen) MPI_Reduce(&gen_time, &gen_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    //1d: poly1 is split over the ranks and whole poly2 is on each; 2d: the first grid column
+    //holds every row block of poly1 once and the first grid row every column block of poly2
+    int match = check_full ? rank == 0 && results_equal(baseline, global_result, 2 * n)
+                           : product_matches(local_poly1, local_start, rank % cols == 0 ? local_len : 0,
+                                             decomp_2d ? local_poly2 : poly2, local_start2, rank < cols ? local_len2 : 0,
+                                             global_result, 0, rank == 0 ? 2 * n + 1 : 0, points);
+
     if (rank == 0) {
-        printf("Time to send slices: %.6f s\n", t_send_end - t_send_start);
-        printf("Parallel computation: %.6f s\n", t_comp_end - t_comp_start);
+        printf("Layout: %d ranks x %d threads (%d cores)\n", size, threads, size * threads);
+        if (local_gen) {
+            printf("Time to generate slices: %.6f s\n", gen_max);
+        }
+        printf("Time to send slices: %.6f s\n", send_time);
+        printf("Parallel computation: %.6f s\n", comp_time);
+        if (chunk > 0) {
+            printf("Pipelined distribution: %d-coefficient chunks, %.1f%% of the distribution window overlapped with computation\n",
+                   chunk, overlap_pct);
+        }
         printf("Time to gather results: %.6f s\n", t_recv_end - t_recv_start);
         printf("Total parallel: %.6f s\n", t_total_end - t_total_start);
+        printf("Decomposition: %s (%d x %d grid), reduction: %s, %s: %s\n",
+               decomp_2d ? "2d" : "1d", rows, cols, banded ? "banded" : "full",
+               check_full ? "match sequential" : "match at random points", match ? "yes" : "no");
 
+        free(baseline);
         free(global_result);
-        free(poly1);
-        free(poly2);
+        if (load_path) {
+            poly_unload(&input);
+        }
+        else {
+            free(poly1);
+            free(poly2);
+        }
     }
 
     free(local_poly1);
+    free(local_poly2);
     free(local_result);
     if (rank != 0) free(poly2);
 
@@ -26,6 +26,7 @@ set REPEATS = 4
 
 set MPI_MACHINES_FILE = "$script_dir/machines"
 set MPI_HOSTS = ""
+set HYBRID_THREADS = 1
 
 set usage_exit = 0
 goto MAIN
@@ -37,6 +38,8 @@ Usage: ./1.sh [options]
 Options:
     --machines-file <path>          Hostfile path (default: ./machines)
     --hosts <h1,h2,...>             Host list (if provided, runs with -hosts)
+    --threads <t>                   Also run each process count p as p/t ranks x t OpenMP
+                                    threads (hybrid MPI+OpenMP) for comparison
     -h, --help                      Show this help
 
 Env vars are not used.
@@ -67,6 +70,16 @@ while ( $#argv > 0 )
             shift argv
             shift argv
             breaksw
+        case "--threads":
+            if ( $#argv < 2 ) then
+                echo "Error: --threads needs a value" >&2
+                set usage_exit = 2
+                goto USAGE
+            endif
+            set HYBRID_THREADS = "$argv[2]"
+            shift argv
+            shift argv
+            breaksw
         case "-h":
         case "--help":
             set usage_exit = 0
@@ -109,17 +122,23 @@ foreach deg ( $DEGREES )
     log ""
 
     set seq_sum = 0
+    set gen_sum = ()
     set send_sum = ()
     set comp_sum = ()
     set recv_sum = ()
     set total_sum = ()
+    set hyb_sum = ()
+    set hyb_comp_sum = ()
 
     @ idx = 1
     while ( $idx <= $#PROCS )
+        set gen_sum = ( $gen_sum 0 )
         set send_sum = ( $send_sum 0 )
         set comp_sum = ( $comp_sum 0 )
         set recv_sum = ( $recv_sum 0 )
         set total_sum = ( $total_sum 0 )
+        set hyb_sum = ( $hyb_sum 0 )
+        set hyb_comp_sum = ( $hyb_comp_sum 0 )
         @ idx++
     end
 
@@ -128,7 +147,7 @@ foreach deg ( $DEGREES )
         @ idx = 1
         foreach p ( $PROCS )
             set tmp = `mktemp`
-            set cmd = ( mpiexec $MPIEXEC_OPTS -n $p "$prog" $deg )
+            set cmd = ( mpiexec $MPIEXEC_OPTS -n $p "$prog" -c $deg )
 
             $cmd >&! "$tmp"
             if ( $status != 0 ) then
@@ -150,7 +169,9 @@ foreach deg ( $DEGREES )
                 set seq_sum = `echo "$seq_sum $seq" | awk '{printf "%.6f", $1+$2}'`
             endif
 
-            # Parallel timings
+            # Parallel timings; generation is only printed for -g local, the default
+            set gen = `awk '/^Time to generate slices:/{for(i=1;i<=NF;i++) if($i ~ /^[0-9]*\.?[0-9]+$/){print $i; exit}}' "$tmp"`
+            if ( "$gen" == "" ) set gen = 0
             set send = `awk '/^(Time to send data:|Time to send slices:)/{for(i=1;i<=NF;i++) if($i ~ /^[0-9]*\.?[0-9]+$/){print $i; exit}}' "$tmp"`
             set comp = `awk '/^(Time for parallel computation:|Parallel computation:)/{for(i=1;i<=NF;i++) if($i ~ /^[0-9]*\.?[0-9]+$/){print $i; exit}}' "$tmp"`
             set recv = `awk '/^(Time to receive results:|Time to gather results:)/{for(i=1;i<=NF;i++) if($i ~ /^[0-9]*\.?[0-9]+$/){print $i; exit}}' "$tmp"`
@@ -163,11 +184,29 @@ foreach deg ( $DEGREES )
                 exit 1
             endif
 
+            set gen_sum[$idx] = `echo "$gen_sum[$idx] $gen" | awk '{printf "%.6f", $1+$2}'`
             set send_sum[$idx] = `echo "$send_sum[$idx] $send" | awk '{printf "%.6f", $1+$2}'`
             set comp_sum[$idx] = `echo "$comp_sum[$idx] $comp" | awk '{printf "%.6f", $1+$2}'`
             set recv_sum[$idx] = `echo "$recv_sum[$idx] $recv" | awk '{printf "%.6f", $1+$2}'`
             set total_sum[$idx] = `echo "$total_sum[$idx] $total" | awk '{printf "%.6f", $1+$2}'`
 
+            # Hybrid layout on the same core count: p/t ranks x t threads
+            @ ranks = $p / $HYBRID_THREADS
+            @ used = $ranks * $HYBRID_THREADS
+            if ( $HYBRID_THREADS > 1 && $ranks > 0 && $used == $p ) then
+                mpiexec $MPIEXEC_OPTS -n $ranks "$prog" -t $HYBRID_THREADS $deg >&! "$tmp"
+                if ( $status != 0 ) then
+                    echo "Error: hybrid run failed for degree=$deg ranks=$ranks threads=$HYBRID_THREADS" >&2
+                    cat "$tmp" >&2
+                    /bin/rm -f "$tmp"
+                    exit 1
+                endif
+                set comp = `awk '/^Parallel computation:/{for(i=1;i<=NF;i++) if($i ~ /^[0-9]*\.?[0-9]+$/){print $i; exit}}' "$tmp"`
+                set total = `awk '/^Total parallel:/{for(i=1;i<=NF;i++) if($i ~ /^[0-9]*\.?[0-9]+$/){print $i; exit}}' "$tmp"`
+                set hyb_sum[$idx] = `echo "$hyb_sum[$idx] $total" | awk '{printf "%.6f", $1+$2}'`
+                set hyb_comp_sum[$idx] = `echo "$hyb_comp_sum[$idx] $comp" | awk '{printf "%.6f", $1+$2}'`
+            endif
+
             /bin/rm -f "$tmp"
             @ idx++
         end
@@ -181,14 +220,24 @@ foreach deg ( $DEGREES )
     @ idx = 1
     foreach p ( $PROCS )
         set total_avg = `echo "$total_sum[$idx] $REPEATS" | awk '{printf "%.6f", $1/$2}'`
+        set gen_avg = `echo "$gen_sum[$idx] $REPEATS" | awk '{printf "%.6f", $1/$2}'`
         set send_avg = `echo "$send_sum[$idx] $REPEATS" | awk '{printf "%.6f", $1/$2}'`
         set comp_avg = `echo "$comp_sum[$idx] $REPEATS" | awk '{printf "%.6f", $1/$2}'`
         set recv_avg = `echo "$recv_sum[$idx] $REPEATS" | awk '{printf "%.6f", $1/$2}'`
 
         log "Parallel multiplication with $p processes average: $total_avg seconds"
+        log "  Generate average: $gen_avg seconds"
         log "  Send average: $send_avg seconds"
         log "  Compute average: $comp_avg seconds"
         log "  Receive average: $recv_avg seconds"
+
+        @ ranks = $p / $HYBRID_THREADS
+        @ used = $ranks * $HYBRID_THREADS
+        if ( $HYBRID_THREADS > 1 && $ranks > 0 && $used == $p ) then
+            set hyb_avg = `echo "$hyb_sum[$idx] $REPEATS" | awk '{printf "%.6f", $1/$2}'`
+            set hyb_comp_avg = `echo "$hyb_comp_sum[$idx] $REPEATS" | awk '{printf "%.6f", $1/$2}'`
+            log "Hybrid multiplication with $ranks ranks x $HYBRID_THREADS threads on $p cores average: $hyb_avg seconds, compute $hyb_comp_avg seconds"
+        endif
         log ""
         @ idx++
     end
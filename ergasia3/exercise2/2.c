@@ -1,8 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <mpi.h>
-#include <time.h>
 #include <string.h>
+#include "rng.h"
 
 typedef struct {
     int* values;
@@ -13,56 +13,61 @@ typedef struct {
 } CSRMatrix;
 
 
-double drand() {
-    return (double)rand() / RAND_MAX;
-}
-int* create_sparse_array(int n, double sparsity) {  // n x n. Flattened matrix.
-    int* A = (int*)malloc(n * n * sizeof(int));
-    if(!A) {
+// Rows [first_row, first_row + rows) of the n x n matrix, flattened. Element (i, j) comes
+// from counters 2(i n + j) and 2(i n + j) + 1 of the stream, so any process can draw its
+// own rows and the matrix is the same for every process count.
+int* create_sparse_rows(int first_row, int rows, int n, double sparsity, uint64_t stream) {
+    int* A = (int*)malloc((size_t)rows * n * sizeof(int));
+    if(!A && rows > 0) {            // A rank without rows may get NULL from malloc(0), which is not a failure.
         fprintf(stderr, "Malloc failed.\n");
         return NULL;
     }
-    for(int i = 0; i < n * n; i++) {
-        if(drand() < sparsity) {
+    for(size_t i = 0; i < (size_t)rows * n; i++) {
+        uint64_t k = 2 * ((uint64_t)first_row * n + i);
+        if(rng_unit(stream, k) < sparsity) {
             A[i] = 0;
         }
         else {
-            A[i] = rand() % 99 + 1;
+            A[i] = rng_int(stream, k + 1, 1, 99);
         }
     }
     return A;
 }
 
-int* create_vector(int n) {        // Create random vector.
+int* create_sparse_array(int n, double sparsity, uint64_t stream) {  // n x n. Flattened matrix.
+    return create_sparse_rows(0, n, n, sparsity, stream);
+}
+
+int* create_vector(int n, uint64_t stream) {        // Create random vector.
     int* vector = (int*)malloc(n * sizeof(int));
     if(!vector){
         fprintf(stderr, "Malloc failed\n");
         return NULL;
     }
     for(int i = 0; i < n; i++) {
-        vector[i] = rand() % 99 + 1;
+        vector[i] = rng_int(stream, i, 1, 99);
     }
     return vector;
 }
 
-CSRMatrix convert_to_csr(int* array, int n) {
+CSRMatrix convert_to_csr(int* array, int rows, int n) {   // rows x n matrix.
 
     CSRMatrix csr;
     int nnz = 0;
 
-    for(int i = 0; i < n * n; i++) {     // Count non zero.
+    for(size_t i = 0; i < (size_t)rows * n; i++) {     // Count non zero.
         if(array[i] != 0) nnz++;
     }
 
     csr.nnz = nnz;
-    csr.rows = n;
+    csr.rows = rows;
     csr.values = (int*)malloc(nnz * sizeof(int));    // Create CSR arrays.
     csr.col_index = (int*)malloc(nnz * sizeof(int));
-    csr.row_ptr = (int*)malloc((n + 1) * sizeof(int));
+    csr.row_ptr = (int*)malloc((rows + 1) * sizeof(int));
 
     int k = 0;
     csr.row_ptr[0] = 0;
-    for(int i = 0; i < n; i++){      // Fill CSR arrays.
+    for(int i = 0; i < rows; i++){      // Fill CSR arrays.
         for(int j = 0; j < n; j++) {
             if(array[i * n + j] != 0) {
                 csr.values[k] = array[i * n + j];
@@ -99,18 +104,16 @@ void dense_multiply_local(int* local_matrix, int* x, int* y, int rows, int cols)
 }
 
 
-void run_serial_process(int n, double sparsity, int iterations) {   // Runs only when we have one process.
-    srand(time(NULL));
-
-    int* matrix = create_sparse_array(n, sparsity);
-    int* global_vector = create_vector(n);
+void run_serial_process(int n, double sparsity, int iterations, uint64_t seed) {   // Runs only when we have one process.
+    int* matrix = create_sparse_array(n, sparsity, rng_stream(seed, 0));
+    int* global_vector = create_vector(n, rng_stream(seed, 1));
     int* x = (int*)malloc(n * sizeof(int));
     int* y = (int*)malloc(n * sizeof(int));
 
     memcpy(x, global_vector, n * sizeof(int));
 
     double t_start = MPI_Wtime();
-    CSRMatrix csr = convert_to_csr(matrix, n);
+    CSRMatrix csr = convert_to_csr(matrix, n, n);
     double t_construct = MPI_Wtime() - t_start;
 
     double t_comm_csr = 0.0;
@@ -163,9 +166,10 @@ int main(int argc, char* argv[]) {
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
-    if(argc != 4) {
+    int local_gen = argc == 4 || (argc == 5 && strcmp(argv[4], "local") == 0);
+    if(argc < 4 || argc > 5 || (argc == 5 && !local_gen && strcmp(argv[4], "root") != 0)) {
         if(rank == 0) {
-            fprintf(stderr, "Usage: %s <n> <sparsity> <iterations> \n", argv[0]);   }
+            fprintf(stderr, "Usage: %s <n> <sparsity> <iterations> [local|root]\n", argv[0]);   }
         MPI_Finalize();
         return 1;
     }
@@ -174,8 +178,11 @@ int main(int argc, char* argv[]) {
     double sparsity = atof(argv[2]);
     int iterations = atoi(argv[3]);
 
+    uint64_t seed = rng_default_seed();      // Same seed everywhere, so every rank draws the same matrix.
+    MPI_Bcast(&seed, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
     if(size == 1) {     // No communication needed for 1 process.
-        run_serial_process(n, sparsity, iterations);
+        run_serial_process(n, sparsity, iterations, seed);
         MPI_Finalize();
         return 0;
     }
@@ -192,13 +199,14 @@ int main(int argc, char* argv[]) {
     CSRMatrix global_csr = {0};
 
 
-    if(rank == 0) {   // Create and initialize matrix and vectors.
-        srand(time(NULL));
-        global_matrix = create_sparse_array(n, sparsity);
-        global_vector = create_vector(n);
+    if(local_gen || rank == 0) {   // Create and initialize vectors (and the matrix at rank 0 with root).
+        global_vector = create_vector(n, rng_stream(seed, 1));
+    }
+    if(!local_gen && rank == 0) {
+        global_matrix = create_sparse_array(n, sparsity, rng_stream(seed, 0));
 
         double t1 = MPI_Wtime();
-        global_csr = convert_to_csr(global_matrix, n);
+        global_csr = convert_to_csr(global_matrix, n, n);
         time_construct = MPI_Wtime() - t1;
     }
 
@@ -217,58 +225,71 @@ int main(int argc, char* argv[]) {
     int local_rows = sendcounts_rows[rank];
 
     int* x = (int*)malloc(n * sizeof(int));      // Broadcast the vector to all processes.
-    if(rank == 0){
+    if(local_gen || rank == 0){
         memcpy(x, global_vector, n * sizeof(int));
     }
-    MPI_Bcast(x, n, MPI_INT, 0, MPI_COMM_WORLD);
+    if(!local_gen) {
+        MPI_Bcast(x, n, MPI_INT, 0, MPI_COMM_WORLD);
+    }
 
-    int* local_row_ptr = (int*)malloc((local_rows + 1) * sizeof(int));
     int* nnz_counts = malloc(size * sizeof(int));
     int* nnz_offset = malloc(size * sizeof(int));
-    MPI_Barrier(MPI_COMM_WORLD);
-    if(rank == 0) {
-        time_comm_s = MPI_Wtime();
-    }
+    int* local_dense_matrix = NULL;
+    CSRMatrix local_csr;
 
+    if(local_gen) {     // Every rank draws its own rows and builds their CSR, nothing is sent.
+        local_dense_matrix = create_sparse_rows(offset_rows[rank], local_rows, n, sparsity, rng_stream(seed, 0));
 
-    MPI_Scatterv(rank == 0 ? global_csr.row_ptr : NULL, sendcounts_rows, offset_rows, MPI_INT,  // Send rows' start indexes.
-                local_row_ptr, local_rows, MPI_INT, 0, MPI_COMM_WORLD);
+        double t1 = MPI_Wtime();
+        local_csr = convert_to_csr(local_dense_matrix, local_rows, n);
+        double t_local = MPI_Wtime() - t1;
+        MPI_Reduce(&t_local, &time_construct, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    }
+    else {
+        int* local_row_ptr = (int*)malloc((local_rows + 1) * sizeof(int));
+        MPI_Barrier(MPI_COMM_WORLD);
+        if(rank == 0) {
+            time_comm_s = MPI_Wtime();
+        }
 
+        MPI_Scatterv(rank == 0 ? global_csr.row_ptr : NULL, sendcounts_rows, offset_rows, MPI_INT,  // Send rows' start indexes.
+                    local_row_ptr, local_rows, MPI_INT, 0, MPI_COMM_WORLD);
 
-    int local_nnz;
 
-    if(rank == 0) {       // Compute non-zeros per process.
-        for(int i = 0; i < size; i++) {
-            int row_s = offset_rows[i];
-            int row_e = row_s + sendcounts_rows[i];
-            nnz_counts[i] = global_csr.row_ptr[row_e] - global_csr.row_ptr[row_s];
-            nnz_offset[i] = global_csr.row_ptr[row_s];
+        int local_nnz;
+
+        if(rank == 0) {       // Compute non-zeros per process.
+            for(int i = 0; i < size; i++) {
+                int row_s = offset_rows[i];
+                int row_e = row_s + sendcounts_rows[i];
+                nnz_counts[i] = global_csr.row_ptr[row_e] - global_csr.row_ptr[row_s];
+                nnz_offset[i] = global_csr.row_ptr[row_s];
+            }
         }
-    }
-    MPI_Scatter(nnz_counts, 1, MPI_INT, &local_nnz, 1, MPI_INT, 0, MPI_COMM_WORLD);
-
-    CSRMatrix local_csr;          // Create local csr, send values and column indices.
-    local_csr.rows = local_rows;
-    local_csr.nnz = local_nnz;
-    local_csr.row_ptr = local_row_ptr;
-    local_csr.values = (int*)malloc(local_nnz * sizeof(int));
-    local_csr.col_index = (int*)malloc(local_nnz * sizeof(int));
-    MPI_Scatterv(rank == 0 ? global_csr.values : NULL, nnz_counts, nnz_offset, MPI_INT, 
-                local_csr.values, local_nnz, MPI_INT, 0, MPI_COMM_WORLD);
-    MPI_Scatterv(rank == 0 ? global_csr.col_index : NULL, nnz_counts, nnz_offset, MPI_INT,
-                local_csr.col_index, local_nnz, MPI_INT, 0, MPI_COMM_WORLD);
-
-    int local_offset = local_row_ptr[0];
-    for(int i = 0; i < local_rows; i++) {    // Adjust row_ptr to local indeces.
-        local_csr.row_ptr[i] -= local_offset;
-    }
-    local_csr.row_ptr[local_rows] = local_nnz;
+        MPI_Scatter(nnz_counts, 1, MPI_INT, &local_nnz, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+        // Create local csr, send values and column indices.
+        local_csr.rows = local_rows;
+        local_csr.nnz = local_nnz;
+        local_csr.row_ptr = local_row_ptr;
+        local_csr.values = (int*)malloc(local_nnz * sizeof(int));
+        local_csr.col_index = (int*)malloc(local_nnz * sizeof(int));
+        MPI_Scatterv(rank == 0 ? global_csr.values : NULL, nnz_counts, nnz_offset, MPI_INT, 
+                    local_csr.values, local_nnz, MPI_INT, 0, MPI_COMM_WORLD);
+        MPI_Scatterv(rank == 0 ? global_csr.col_index : NULL, nnz_counts, nnz_offset, MPI_INT,
+                    local_csr.col_index, local_nnz, MPI_INT, 0, MPI_COMM_WORLD);
+
+        int local_offset = local_row_ptr[0];
+        for(int i = 0; i < local_rows; i++) {    // Adjust row_ptr to local indeces.
+            local_csr.row_ptr[i] -= local_offset;
+        }
+        local_csr.row_ptr[local_rows] = local_nnz;
 
-    if(rank == 0) {
-        time_comm_e = MPI_Wtime();
+        if(rank == 0) {
+            time_comm_e = MPI_Wtime();
+        }
     }
 
-
     int* local_y = (int*)malloc(local_rows * sizeof(int));
     MPI_Barrier(MPI_COMM_WORLD);
 
@@ -296,29 +317,33 @@ int main(int argc, char* argv[]) {
     }
 
 
-    if(rank == 0) {
+    if(local_gen || rank == 0) {
         memcpy(x, global_vector, n * sizeof(int));
     }
-    MPI_Bcast(x, n, MPI_INT, 0, MPI_COMM_WORLD);
+    if(!local_gen) {
+        MPI_Bcast(x, n, MPI_INT, 0, MPI_COMM_WORLD);
+    }
 
     int* sendcounts_dense = malloc(size * sizeof(int));
     int* offset_dense = malloc(size * sizeof(int));
-    int* local_dense_matrix = malloc(local_rows * n * sizeof(int));
 
     for(int i = 0; i < size; i++) {
         sendcounts_dense[i] = sendcounts_rows[i] * n;
         offset_dense[i] = offset_rows[i] * n;
     }
 
-    MPI_Barrier(MPI_COMM_WORLD);
-    if(rank == 0) {
-        time_dense_comm_s = MPI_Wtime();
-    }
-    MPI_Scatterv(global_matrix, sendcounts_dense, offset_dense, MPI_INT,
-                 local_dense_matrix, local_rows * n, MPI_INT, 0, MPI_COMM_WORLD);
-    MPI_Barrier(MPI_COMM_WORLD);
-    if(rank == 0) {
-        time_dense_comm_e = MPI_Wtime();
+    if(!local_gen) {      // With local generation the rows are already in place.
+        local_dense_matrix = malloc(local_rows * n * sizeof(int));
+        MPI_Barrier(MPI_COMM_WORLD);
+        if(rank == 0) {
+            time_dense_comm_s = MPI_Wtime();
+        }
+        MPI_Scatterv(global_matrix, sendcounts_dense, offset_dense, MPI_INT,
+                     local_dense_matrix, local_rows * n, MPI_INT, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        if(rank == 0) {
+            time_dense_comm_e = MPI_Wtime();
+        }
     }
 
     time_dense_calc_s = MPI_Wtime();
@@ -350,9 +375,9 @@ int main(int argc, char* argv[]) {
     free(offset_dense);
     free(local_dense_matrix);
 
+    free(global_vector);
     if(rank == 0) {
         free(global_matrix);
-        free(global_vector);
         free(global_csr.values);
         free(global_csr.col_index);
         free(global_csr.row_ptr);
@@ -2,108 +2,94 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
-#include <immintrin.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include "poly.h"
+#include "rng.h"
+#include "ntt.h"
+#include "simd.h"
+#include "polyio.h"
+#include "kernels.h"
 
-#define LOWER_BOUND -20
-#define UPPER_BOUND 20
+#define KARATSUBA_THRESHOLD 64      // Below this length fall back to the SIMD kernel.
 
-double now_seconds(void) {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ts.tv_sec + ts.tv_nsec * 1e-9;
-}
+int karatsuba_threshold = KARATSUBA_THRESHOLD;
 
-int* create_random_polynomial(int degree) {
-    int *poly = (int *)malloc((size_t)(degree + 1) * sizeof(int));
-    if(!poly) {
-        perror("malloc");
-        exit(EXIT_FAILURE);
-    }
-    for(int i = 0; i <= degree; ++i) {
-        int r;
-        do {
-            r = (rand() % (UPPER_BOUND - LOWER_BOUND + 1)) + LOWER_BOUND;
-        } while(r == 0);       // If 0, regenerate to avoid zero coefficients.
-        poly[i] = r;
-    }
-    return poly;
-}
-
-int* multiply_sequential(const int *poly1, int deg1, const int *poly2, int deg2) {
+int* multiply_simd(const int *poly1, int deg1, const int *poly2, int deg2) {
     int result_len = deg1 + deg2 + 1;
     int *result = (int *)calloc((size_t)result_len, sizeof(int));
     if(!result) {
         perror("calloc");
         exit(EXIT_FAILURE);
     }
-    for(int i = 0; i <= deg1; ++i) {
-        for(int j = 0; j <= deg2; ++j) {
-            result[i + j] += poly1[i] * poly2[j];
-        }
-    }
+    simd_kernel(poly1, deg1, poly2, deg2, result);
     return result;
 }
 
-int* multiply_simd(const int *poly1, int deg1, const int *poly2, int deg2) {
-    int result_len = deg1 + deg2 + 1;
-    int *result = (int *)calloc((size_t)result_len, sizeof(int));
-    if(!result) {
-        perror("calloc");
-        exit(EXIT_FAILURE);
-    }
-
-    for(int i = 0; i <= deg1; ++i) {
-
-        __m256i p1_vec = _mm256_set1_epi32(poly1[i]);
-
-        int j = 0;
-        for(; j <= deg2 - 7; j += 8) {
-            __m256i p2_vec = _mm256_loadu_si256((__m256i*)&poly2[j]);
-
-            __m256i result_vec = _mm256_loadu_si256((__m256i*)&result[i + j]);
-
-            __m256i product = _mm256_mullo_epi32(p1_vec, p2_vec);
-
-            result_vec = _mm256_add_epi32(result_vec, product);
+int main(int argc, char *argv[]) {
 
-            _mm256_storeu_si256((__m256i*)&result[i + j], result_vec);
+    const char *usage = "Usage: %s [-k karatsuba_threshold] [-i avx512|avx2|sse4.1|scalar] [--save file] {--load file | <degree1> <degree2>}\n";
+    const char *forced_isa = NULL;
+    const char *load_path = NULL;
+    const char *save_path = NULL;
+    static const struct option long_options[] = {
+        {"load", required_argument, NULL, 'L'},
+        {"save", required_argument, NULL, 'S'},
+        {NULL, 0, NULL, 0}
+    };
+
+    int opt;
+    while((opt = getopt_long(argc, argv, "k:i:", long_options, NULL)) != -1) {
+        if(opt == 'L') {
+            load_path = optarg;
         }
-
-        for(; j <= deg2; ++j) {    // Handle remaining coefficients.
-            result[i + j] += poly1[i] * poly2[j];
+        else if(opt == 'S') {
+            save_path = optarg;
         }
-    }
-    return result;
-}
-
-int results_equal(const int *res1, const int *res2, int degree) {
-    for (int i = 0; i <= degree; ++i) {
-        if (res1[i] != res2[i]) {
-            return 0;
+        else if(opt == 'k') {
+            karatsuba_threshold = atoi(optarg);
+        }
+        else if(opt == 'i') {
+            forced_isa = optarg;
+        }
+        else {
+            fprintf(stderr, usage, argv[0]);
+            return EXIT_FAILURE;
         }
     }
-    return 1;
-}
-
 
-int main(int argc, char *argv[]) {
+    if ((!load_path && argc - optind < 2) || karatsuba_threshold < 1) {
+        fprintf(stderr, usage, argv[0]);
+        return EXIT_FAILURE;
+    }
 
-    if (argc < 3) {
-        fprintf(stderr, "Usage: %s <degree1> <degree2>\n", argv[0]);
+    if(!select_simd_kernel(forced_isa)) {
+        fprintf(stderr, "SIMD kernel '%s' is unknown or not supported by this CPU.\n", forced_isa);
         return EXIT_FAILURE;
     }
+    printf("SIMD kernel: %s\n", simd_kernel_name);
 
-    int degree1 = atoi(argv[1]);
-    int degree2 = atoi(argv[2]);
+    int degree1 = load_path ? 0 : atoi(argv[optind]);
+    int degree2 = load_path ? 0 : atoi(argv[optind + 1]);
 
-    srand(time(NULL));
+    poly_seed(rng_default_seed());
 
+    poly_file_t input = {0};
+    int *poly1, *poly2;
     double create_start = now_seconds();
-    int *poly1 = create_random_polynomial(degree1);
-    int *poly2 = create_random_polynomial(degree2);
+    if(load_path) {
+        poly_load_pair(load_path, &input, &poly1, &degree1, &poly2, &degree2);
+    }
+    else {
+        poly1 = create_nonzero_polynomial(degree1);
+        poly2 = create_nonzero_polynomial(degree2);
+    }
     double create_end = now_seconds();
-    printf("Generated polynomials in %.3f seconds\n", create_end - create_start);
+    printf("%s polynomials in %.3f seconds\n", load_path ? "Loaded" : "Generated", create_end - create_start);
+    if(save_path) {
+        poly_save_pair(save_path, poly1, degree1, poly2, degree2);
+    }
 
     double seq_start = now_seconds();
     int *baseline = multiply_sequential(poly1, degree1, poly2, degree2);
@@ -113,14 +99,79 @@ int main(int argc, char *argv[]) {
     double simd_start = now_seconds();
     int *simd_result = multiply_simd(poly1, degree1, poly2, degree2);
     double simd_end = now_seconds();
-    printf("SIMD multiplication took %.3f seconds\n", simd_end - simd_start);
+    double products = (double)(degree1 + 1) * (double)(degree2 + 1);
+    printf("SIMD multiplication took %.3f seconds (%.2f G mul-add/s)\n",
+           simd_end - simd_start, products / (simd_end - simd_start) * 1e-9);
 
     printf("Match baseline: %s\n", results_equal(baseline, simd_result, degree1 + degree2) ? "yes" : "no");
 
-    free(poly1);
-    free(poly2);
+    simd_kernel_fn regblock_kernel = select_regblock_kernel();
+    if(regblock_kernel) {
+        int *rb_result = (int *)calloc((size_t)(degree1 + degree2 + 1), sizeof(int));
+        if(!rb_result) {
+            perror("calloc");
+            exit(EXIT_FAILURE);
+        }
+        double rb_start = now_seconds();
+        regblock_kernel(poly1, degree1, poly2, degree2, rb_result);
+        double rb_end = now_seconds();
+        printf("Register-blocked SIMD multiplication took %.3f seconds (%.2f G mul-add/s)\n",
+               rb_end - rb_start, products / (rb_end - rb_start) * 1e-9);
+        printf("Match baseline: %s\n", results_equal(baseline, rb_result, degree1 + degree2) ? "yes" : "no");
+        free(rb_result);
+    }
+    else {
+        printf("Register-blocked SIMD multiplication skipped (needs AVX2 or AVX-512)\n");
+    }
+
+    // The int16 path is only taken when the range check proves it gives the same result.
+    if(narrow_range_safe(poly1, degree1, poly2, degree2)) {
+        narrow_kernel_fn narrow_kernel = select_narrow_kernel();
+        int16_t *narrow1 = narrow_copy(poly1, degree1);
+        int16_t *narrow2 = narrow_copy(poly2, degree2);
+        int *narrow_result = (int *)calloc((size_t)(degree1 + degree2 + 1), sizeof(int));
+        if(!narrow_result) {
+            perror("calloc");
+            exit(EXIT_FAILURE);
+        }
+        double narrow_start = now_seconds();
+        narrow_kernel(narrow1, degree1, narrow2, degree2, narrow_result);
+        double narrow_end = now_seconds();
+        printf("Narrow int16 %s multiplication took %.3f seconds (%.2f G mul-add/s)\n",
+               narrow_kernel == narrow_kernel_avx2 ? "madd" : "scalar",
+               narrow_end - narrow_start, products / (narrow_end - narrow_start) * 1e-9);
+        printf("Match baseline: %s\n", results_equal(baseline, narrow_result, degree1 + degree2) ? "yes" : "no");
+        free(narrow1);
+        free(narrow2);
+        free(narrow_result);
+    }
+    else {
+        printf("Narrow int16 multiplication skipped (coefficients out of range)\n");
+    }
+
+    double kara_start = now_seconds();
+    int *kara_result = multiply_karatsuba(poly1, degree1, poly2, degree2, karatsuba_threshold, simd_kernel, 1);
+    double kara_end = now_seconds();
+    printf("Karatsuba SIMD multiplication took %.3f seconds\n", kara_end - kara_start);
+    printf("Match baseline: %s\n", results_equal(baseline, kara_result, degree1 + degree2) ? "yes" : "no");
+
+    double ntt_start = now_seconds();
+    int *ntt_result = multiply_ntt(poly1, degree1, poly2, degree2, 0);
+    double ntt_end = now_seconds();
+    printf("NTT multiplication took %.3f seconds\n", ntt_end - ntt_start);
+    printf("Match baseline: %s\n", results_equal(baseline, ntt_result, degree1 + degree2) ? "yes" : "no");
+
+    if(load_path) {
+        poly_unload(&input);
+    }
+    else {
+        free(poly1);
+        free(poly2);
+    }
     free(baseline);
     free(simd_result);
+    free(kara_result);
+    free(ntt_result);
 
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -31,7 +31,7 @@ for deg in "${DEGREES[@]}"; do
 
         if [ ! -x "$PROG" ]; then
             echo "Error: executable '$PROG' not found." | tee -a "$OUTPUT_FILE"
-            echo "Please compile with: gcc -O3 -mavx2 -o 1 1.c"
+            echo "Please build it first with: make (in ergasia4)"
             exit 1
         fi
 
@@ -54,7 +54,7 @@ for deg in "${DEGREES[@]}"; do
 
 
     simd_sum=0
-    simd_times=$(grep "SIMD multiplication took" "$OUTPUT_FILE" | tail -"$REPEATS" | awk '{print $4}')
+    simd_times=$(grep "^SIMD multiplication took" "$OUTPUT_FILE" | tail -"$REPEATS" | awk '{print $4}')
     
     for val in $simd_times; do
         simd_sum=$(echo "$simd_sum + $val" | bc)
@@ -71,6 +71,60 @@ for deg in "${DEGREES[@]}"; do
         echo "Speedup: N/A (too fast)" | tee -a "$OUTPUT_FILE"
     fi
 
+
+    # Only printed when the CPU has AVX2 or AVX-512.
+    rb_sum=0
+    rb_times=$(grep "^Register-blocked SIMD multiplication took" "$OUTPUT_FILE" | tail -"$REPEATS" | awk '{print $5}')
+
+    if [ -n "$rb_times" ]; then
+        for val in $rb_times; do
+            rb_sum=$(echo "$rb_sum + $val" | bc)
+        done
+
+        rb_avg=$(echo "scale=6; $rb_sum / $REPEATS" | bc)
+        echo "Register-blocked Avg Time: $rb_avg seconds" | tee -a "$OUTPUT_FILE"
+    else
+        echo "Register-blocked Avg Time: skipped" | tee -a "$OUTPUT_FILE"
+    fi
+
+
+    kara_sum=0
+    kara_times=$(grep "^Karatsuba SIMD multiplication took" "$OUTPUT_FILE" | tail -"$REPEATS" | awk '{print $5}')
+
+    for val in $kara_times; do
+        kara_sum=$(echo "$kara_sum + $val" | bc)
+    done
+
+    kara_avg=$(echo "scale=6; $kara_sum / $REPEATS" | bc)
+    echo "Karatsuba Avg Time:  $kara_avg seconds" | tee -a "$OUTPUT_FILE"
+
+
+    # Only printed when every coefficient fits in int16; the kernel name sits before "multiplication".
+    narrow_sum=0
+    narrow_times=$(grep "^Narrow int16 [^ ]* multiplication took" "$OUTPUT_FILE" | tail -"$REPEATS" | awk '{print $6}')
+
+    if [ -n "$narrow_times" ]; then
+        for val in $narrow_times; do
+            narrow_sum=$(echo "$narrow_sum + $val" | bc)
+        done
+
+        narrow_avg=$(echo "scale=6; $narrow_sum / $REPEATS" | bc)
+        echo "Narrow int16 Avg Time: $narrow_avg seconds" | tee -a "$OUTPUT_FILE"
+    else
+        echo "Narrow int16 Avg Time: skipped" | tee -a "$OUTPUT_FILE"
+    fi
+
+
+    ntt_sum=0
+    ntt_times=$(grep "^NTT multiplication took" "$OUTPUT_FILE" | tail -"$REPEATS" | awk '{print $4}')
+
+    for val in $ntt_times; do
+        ntt_sum=$(echo "$ntt_sum + $val" | bc)
+    done
+
+    ntt_avg=$(echo "scale=6; $ntt_sum / $REPEATS" | bc)
+    echo "NTT Avg Time:        $ntt_avg seconds" | tee -a "$OUTPUT_FILE"
+
     echo "" >> "$OUTPUT_FILE"
     echo "-------------------------------------" >> "$OUTPUT_FILE"
 done
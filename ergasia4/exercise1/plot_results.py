@@ -3,7 +3,7 @@
 import argparse
 import pathlib
 import sys
-from typing import List, Tuple, Optional
+from typing import Dict, List, Tuple, Optional
 
 try:
     import matplotlib.pyplot as plt
@@ -11,7 +11,15 @@ except ImportError:
     print("Error: Matplotlib is required. Install it with 'pip install matplotlib'")
     sys.exit(1)
 
-Row = Tuple[int, float, float, Optional[float]]
+Row = Tuple[int, float, float, Optional[float], Dict[str, float]]
+
+# Summary prefix printed by 1.sh -> legend label; lines reading "skipped" are left out.
+ENGINES = [
+    ("Register-blocked Avg Time:", "Register-blocked SIMD"),
+    ("Karatsuba Avg Time:", "Karatsuba SIMD"),
+    ("Narrow int16 Avg Time:", "Narrow int16"),
+    ("NTT Avg Time:", "NTT"),
+]
 
 def parse_results(path: pathlib.Path) -> List[Row]:
     rows: List[Row] = []
@@ -20,6 +28,7 @@ def parse_results(path: pathlib.Path) -> List[Row]:
     seq_time = None
     simd_time = None
     speedup = None
+    engines: Dict[str, float] = {}
 
     if not path.exists():
         print(f"Error: Results file not found at {path}")
@@ -37,11 +46,12 @@ def parse_results(path: pathlib.Path) -> List[Row]:
             if line.startswith("Testing degree ="):
 
                 if current_degree is not None and seq_time is not None and simd_time is not None:
-                    rows.append((current_degree, seq_time, simd_time, speedup))
+                    rows.append((current_degree, seq_time, simd_time, speedup, engines))
 
                     seq_time = None
                     simd_time = None
                     speedup = None
+                    engines = {}
                 
                 try:
 
@@ -75,9 +85,20 @@ def parse_results(path: pathlib.Path) -> List[Row]:
                 except (IndexError, ValueError):
                     pass
 
+            else:
+                for prefix, label in ENGINES:
+                    if line.startswith(prefix):
+                        try:
+                            val_str = line.split(":")[1].strip().split()[0]
+                            if val_str != "skipped":
+                                engines[label] = float(val_str)
+                        except (IndexError, ValueError):
+                            pass
+                        break
+
 
     if current_degree is not None and seq_time is not None and simd_time is not None:
-        rows.append((current_degree, seq_time, simd_time, speedup))
+        rows.append((current_degree, seq_time, simd_time, speedup, engines))
 
     if not rows:
         print(f"Warning: No valid summary data found in {path}.")
@@ -103,8 +124,13 @@ def plot(rows: List[Row], output_dir: pathlib.Path) -> None:
     
     plt.plot(degrees, seq_times, marker='o', label='Sequential', linestyle='-', color='#d62728', linewidth=2)
     plt.plot(degrees, simd_times, marker='s', label='SIMD (AVX2)', linestyle='-', color='#2ca02c', linewidth=2)
+
+    for (_, label), marker in zip(ENGINES, ['^', 'v', 'D', 'x']):
+        points = [(r[0], r[4][label]) for r in rows if label in r[4]]
+        if points:
+            plt.plot([p[0] for p in points], [p[1] for p in points], marker=marker, label=label, linestyle='--', linewidth=1.5)
     
-    plt.title("Performance Comparison: Sequential vs SIMD", fontsize=14)
+    plt.title("Performance Comparison: Sequential vs SIMD Engines", fontsize=14)
     plt.xlabel("Polynomial Degree (N)", fontsize=12)
     plt.ylabel("Execution Time (seconds)", fontsize=12)
     plt.legend(fontsize=12)
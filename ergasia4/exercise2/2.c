@@ -0,0 +1,117 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <getopt.h>
+#include "poly.h"
+#include "rng.h"
+#include "simd.h"
+#include "dispatch.h"
+#include "polyio.h"
+
+void run_hybrid(const char *label, const int *poly1, int deg1, const int *poly2, int deg2,
+                int threads, simd_kernel_fn kernel, const int *baseline, double seq_time) {
+    double start = now_seconds();
+    int *result = multiply_hybrid(poly1, deg1, poly2, deg2, threads, kernel);
+    double end = now_seconds();
+    printf("Hybrid %s multiplication with %d threads took %.3f seconds (speedup %.2fx)\n",
+           label, threads, end - start, seq_time / (end - start));
+    printf("Match baseline: %s\n", results_equal(baseline, result, deg1 + deg2) ? "yes" : "no");
+    free(result);
+}
+
+
+int main(int argc, char *argv[]) {
+    const char *usage = "Usage: %s [-i avx512|avx2|sse4.1|scalar] [--save file] {--load file | <degree1> <degree2>} <threads...>\n";
+    const char *forced_isa = NULL;
+    const char *load_path = NULL;
+    const char *save_path = NULL;
+    static const struct option long_options[] = {
+        {"load", required_argument, NULL, 'L'},
+        {"save", required_argument, NULL, 'S'},
+        {NULL, 0, NULL, 0}
+    };
+
+    int opt;
+    while((opt = getopt_long(argc, argv, "i:", long_options, NULL)) != -1) {
+        if(opt == 'L') {
+            load_path = optarg;
+        }
+        else if(opt == 'S') {
+            save_path = optarg;
+        }
+        else if(opt == 'i') {
+            forced_isa = optarg;
+        }
+        else {
+            fprintf(stderr, usage, argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // --load takes the place of the two degrees
+    int first_thread = optind + (load_path ? 0 : 2);
+    if(argc - first_thread < 1) {
+        fprintf(stderr, usage, argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if(!select_simd_kernel(forced_isa)) {
+        fprintf(stderr, "SIMD kernel '%s' is unknown or not supported by this CPU.\n", forced_isa);
+        return EXIT_FAILURE;
+    }
+
+    // SIMD on: the register-blocked kernel when the ISA has one, else the plain vector kernel.
+    simd_kernel_fn vector_kernel = select_regblock_kernel();
+    printf("SIMD kernel: %s%s\n", simd_kernel_name, vector_kernel ? " (register-blocked)" : "");
+    if(!vector_kernel) vector_kernel = simd_kernel;
+
+    int degree1 = load_path ? 0 : atoi(argv[optind]);
+    int degree2 = load_path ? 0 : atoi(argv[optind + 1]);
+
+    poly_seed(rng_default_seed());
+
+    poly_file_t input = {0};
+    int *poly1, *poly2;
+    double create_start = now_seconds();
+    if(load_path) {
+        poly_load_pair(load_path, &input, &poly1, &degree1, &poly2, &degree2);
+    }
+    else {
+        poly1 = create_nonzero_polynomial(degree1);
+        poly2 = create_nonzero_polynomial(degree2);
+    }
+    double create_end = now_seconds();
+    printf("%s polynomials in %.3f seconds\n", load_path ? "Loaded" : "Generated", create_end - create_start);
+    if(save_path) {
+        poly_save_pair(save_path, poly1, degree1, poly2, degree2);
+    }
+
+    double seq_start = now_seconds();
+    int *baseline = multiply_sequential(poly1, degree1, poly2, degree2);
+    double seq_end = now_seconds();
+    double seq_time = seq_end - seq_start;
+    printf("Sequential multiplication took %.3f seconds\n", seq_time);
+
+    for(int arg = first_thread; arg < argc; ++arg) {
+        int threads = atoi(argv[arg]);
+        if(threads <= 0) {
+            fprintf(stderr, "Thread count must be positive (got %d).\n", threads);
+            continue;
+        }
+        run_hybrid("scalar", poly1, degree1, poly2, degree2, threads, simd_kernel_scalar, baseline, seq_time);
+        run_hybrid("SIMD", poly1, degree1, poly2, degree2, threads, vector_kernel, baseline, seq_time);
+    }
+
+    if(load_path) {
+        poly_unload(&input);
+    }
+    else {
+        free(poly1);
+        free(poly2);
+    }
+    free(baseline);
+
+    return EXIT_SUCCESS;
+}
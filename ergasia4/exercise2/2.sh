@@ -0,0 +1,56 @@
+#!/bin/bash
+
+SCRIPT_DIR=$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)
+ROOT_DIR=$(cd "$SCRIPT_DIR/.." && pwd)
+
+RESULTS_DIR="$ROOT_DIR/results"
+
+mkdir -p "$RESULTS_DIR"
+
+PROG="$ROOT_DIR/build/2"
+OUTPUT_FILE="$RESULTS_DIR/2.txt"
+
+DEGREES=(50000 100000 500000)
+THREADS=(1 2 4 8 16)
+REPEATS=3
+
+echo "--------Polynomial Multiplication Threads x SIMD Benchmark--------" > "$OUTPUT_FILE"
+echo "" >> "$OUTPUT_FILE"
+
+if [ ! -x "$PROG" ]; then
+    echo "Error: executable '$PROG' not found." | tee -a "$OUTPUT_FILE"
+    echo "Please build it first with: make (in ergasia4)"
+    exit 1
+fi
+
+for deg in "${DEGREES[@]}"; do
+
+    echo "Testing degree = $deg" | tee -a "$OUTPUT_FILE"
+    echo "-------------------------------------" | tee -a "$OUTPUT_FILE"
+    echo "Running: degree1 = $deg, degree2 = $deg, threads = ${THREADS[*]}" | tee -a "$OUTPUT_FILE"
+
+    for ((run=1; run<=REPEATS; run++)); do
+        echo "" | tee -a "$OUTPUT_FILE"
+        echo "Run $run:" | tee -a "$OUTPUT_FILE"
+        "$PROG" "$deg" "$deg" "${THREADS[@]}" | tee -a "$OUTPUT_FILE"
+    done
+
+    echo "" | tee -a "$OUTPUT_FILE"
+    echo "===== AVERAGES =====" | tee -a "$OUTPUT_FILE"
+
+    seq_avg=$(grep "Sequential multiplication took" "$OUTPUT_FILE" | tail -"$REPEATS" | awk '{s += $4} END {printf "%.4f", s / NR}')
+    echo "Sequential multiplication average: $seq_avg seconds" | tee -a "$OUTPUT_FILE"
+
+    for th in "${THREADS[@]}"; do
+        for mode in scalar SIMD; do
+            avg=$(grep "Hybrid $mode multiplication with $th threads took" "$OUTPUT_FILE" | tail -"$REPEATS" | awk '{s += $8} END {printf "%.4f", s / NR}')
+            speedup=$(echo "$seq_avg $avg" | awk '{ if ($2 > 0) printf "%.2f", $1 / $2; else print "N/A" }')
+            echo "Hybrid $mode with $th threads average: $avg seconds (speedup ${speedup}x)" | tee -a "$OUTPUT_FILE"
+        done
+    done
+
+    echo "" >> "$OUTPUT_FILE"
+    echo "-------------------------------------" >> "$OUTPUT_FILE"
+done
+
+echo "Benchmarks completed. Results saved in $OUTPUT_FILE"
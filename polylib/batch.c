@@ -0,0 +1,119 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "batch.h"
+#include <string.h>
+#include <omp.h>
+
+#define AVX2 __attribute__((target("avx2")))
+
+size_t batch_layout(const poly_pair_t *pairs, int count, size_t *offsets)
+{
+    size_t total = 0;
+    for (int p = 0; p < count; ++p) {
+        offsets[p] = total;
+        total += (size_t)pairs[p].deg1 + pairs[p].deg2 + 1;
+    }
+    return total;
+}
+
+static void multiply_pair(const poly_pair_t *pair, int *result)
+{
+    const int *poly1 = pair->poly1;
+    const int *poly2 = pair->poly2;
+    int deg2 = pair->deg2;
+    memset(result, 0, ((size_t)pair->deg1 + deg2 + 1) * sizeof(int));
+    for (int i = 0; i <= pair->deg1; ++i) {
+        int a = poly1[i];
+        int *row = result + i;
+        #pragma omp simd
+        for (int j = 0; j <= deg2; ++j) {
+            row[j] += a * poly2[j];
+        }
+    }
+}
+
+// BATCH_LANES pairs of equal degrees, interleaved so coefficient k of every
+// pair sits in one vector and each mul-add serves all lanes at once.
+static inline __attribute__((always_inline)) void multiply_lanes_body(const poly_pair_t *pairs, int *arena,
+                                                                      const size_t *offsets)
+{
+    int deg1 = pairs[0].deg1, deg2 = pairs[0].deg2;
+    int a[(BATCH_LANE_MAX_DEG + 1) * BATCH_LANES];
+    int b[(BATCH_LANE_MAX_DEG + 1) * BATCH_LANES];
+    int r[(2 * BATCH_LANE_MAX_DEG + 1) * BATCH_LANES];
+
+    for (int l = 0; l < BATCH_LANES; ++l) {
+        for (int i = 0; i <= deg1; ++i) a[i * BATCH_LANES + l] = pairs[l].poly1[i];
+        for (int j = 0; j <= deg2; ++j) b[j * BATCH_LANES + l] = pairs[l].poly2[j];
+    }
+    memset(r, 0, ((size_t)deg1 + deg2 + 1) * BATCH_LANES * sizeof(int));
+
+    for (int i = 0; i <= deg1; ++i) {
+        for (int j = 0; j <= deg2; ++j) {
+            int *rk = r + (i + j) * BATCH_LANES;
+            const int *ai = a + i * BATCH_LANES;
+            const int *bj = b + j * BATCH_LANES;
+            #pragma omp simd
+            for (int l = 0; l < BATCH_LANES; ++l) {
+                rk[l] += ai[l] * bj[l];
+            }
+        }
+    }
+
+    for (int l = 0; l < BATCH_LANES; ++l) {
+        int *result = arena + offsets[l];
+        for (int k = 0; k <= deg1 + deg2; ++k) result[k] = r[k * BATCH_LANES + l];
+    }
+}
+
+static void multiply_lanes(const poly_pair_t *pairs, int *arena, const size_t *offsets)
+{
+    multiply_lanes_body(pairs, arena, offsets);
+}
+
+static AVX2 void multiply_lanes_avx2(const poly_pair_t *pairs, int *arena, const size_t *offsets)
+{
+    multiply_lanes_body(pairs, arena, offsets);
+}
+
+static int lane_group(const poly_pair_t *pairs, int first, int last)
+{
+    if (last - first < BATCH_LANES) return 0;
+    int deg1 = pairs[first].deg1, deg2 = pairs[first].deg2;
+    if (deg1 > BATCH_LANE_MAX_DEG || deg2 > BATCH_LANE_MAX_DEG) return 0;
+    for (int p = first + 1; p < first + BATCH_LANES; ++p) {
+        if (pairs[p].deg1 != deg1 || pairs[p].deg2 != deg2) return 0;
+    }
+    return 1;
+}
+
+void multiply_batch_range(const poly_pair_t *pairs, int first, int last, int *arena, const size_t *offsets)
+{
+    int use_avx2 = __builtin_cpu_supports("avx2");
+    int p = first;
+    while (p < last) {
+        if (lane_group(pairs, p, last)) {
+            if (use_avx2) multiply_lanes_avx2(pairs + p, arena, offsets + p);
+            else multiply_lanes(pairs + p, arena, offsets + p);
+            p += BATCH_LANES;
+        }
+        else {
+            multiply_pair(&pairs[p], arena + offsets[p]);
+            ++p;
+        }
+    }
+}
+
+void multiply_batch(const poly_pair_t *pairs, int count, int *arena, const size_t *offsets, int threads)
+{
+    if (threads <= 0) threads = omp_get_max_threads();
+    int groups = (count + BATCH_LANES - 1) / BATCH_LANES;
+
+    // Whole lane groups per iteration, so each thread still sees full groups.
+    #pragma omp parallel for schedule(guided) num_threads(threads)
+    for (int g = 0; g < groups; ++g) {
+        int first = g * BATCH_LANES;
+        int last = first + BATCH_LANES < count ? first + BATCH_LANES : count;
+        multiply_batch_range(pairs, first, last, arena, offsets);
+    }
+}
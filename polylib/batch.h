@@ -0,0 +1,29 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stddef.h>
+
+#define BATCH_LANES 8           // pairs per interleaved group, one 256-bit int vector
+#define BATCH_LANE_MAX_DEG 32   // larger pairs vectorise well on their own
+
+// Many independent products written into one output arena. Product p starts
+// at arena + offsets[p] and has deg1 + deg2 + 1 coefficients.
+typedef struct {
+    const int *poly1;
+    int deg1;
+    const int *poly2;
+    int deg2;
+} poly_pair_t;
+
+// Fills offsets[0..count-1] and returns the arena length in ints, so one
+// allocation can be reused across batches with the same shapes.
+size_t batch_layout(const poly_pair_t *pairs, int count, size_t *offsets);
+
+// Serial worker for pairs [first, last). Runs of BATCH_LANES pairs with the
+// same small degrees are multiplied together, one pair per vector lane.
+void multiply_batch_range(const poly_pair_t *pairs, int first, int last, int *arena, const size_t *offsets);
+
+// Spreads the batch over an OpenMP team; threads <= 0 uses the default count.
+void multiply_batch(const poly_pair_t *pairs, int count, int *arena, const size_t *offsets, int threads);
+
+#endif
@@ -0,0 +1,46 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <omp.h>
+#include "dispatch.h"
+
+// Measures the engine crossovers on this host for poly_multiply() and prints
+// the plan it will now choose for a range of square sizes.
+int main(int argc, char *argv[])
+{
+    const char *usage = "Usage: %s [-t max_threads] [-o calibration_file]\n";
+    const char *path = NULL;
+    int max_threads = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "t:o:")) != -1) {
+        if (opt == 't') {
+            max_threads = atoi(optarg);
+        }
+        else if (opt == 'o') {
+            path = optarg;
+        }
+        else {
+            fprintf(stderr, usage, argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (!path) path = poly_calibration_path();
+    if (max_threads <= 0) max_threads = omp_get_max_threads();
+
+    printf("Calibrating with up to %d threads...\n", max_threads);
+    if (poly_calibrate(path, max_threads) != 0) {
+        return EXIT_FAILURE;
+    }
+    printf("Wrote %s\n", path);
+
+    for (int n = 16; n <= 1 << 20; n *= 4) {
+        poly_plan_t serial = poly_plan(n - 1, n - 1, 1);
+        poly_plan_t parallel = poly_plan(n - 1, n - 1, max_threads);
+        printf("n = %7d: 1 thread -> %s, %d threads -> %s x %d\n", n, poly_engine_name(serial.engine),
+               max_threads, poly_engine_name(parallel.engine), parallel.threads);
+    }
+    return EXIT_SUCCESS;
+}
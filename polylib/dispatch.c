@@ -0,0 +1,313 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "dispatch.h"
+#include "ntt.h"
+#include "poly.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include <pthread.h>
+
+#define REDUCE_SLICE 4096           // Output coefficients per reduction work item.
+
+#define CAL_SIZES 7
+#define CAL_MAX_ENTRIES 512
+#define CAL_MIN_SECONDS 0.05        // Repeat each measurement until this much time has passed...
+#define CAL_MAX_REPEATS 5           // ...or this many runs, and keep the fastest.
+#define CAL_PRUNE 8.0               // Stop timing a quadratic configuration once it is this much slower than NTT.
+#define NTT_RATIO 290.0             // Uncalibrated: NTT once the mul-adds reach this many times its L log L...
+#define NTT_RATIO_THREADED 540.0    // ...or this many against the threaded kernel (squares cross at 8192 and 16384).
+
+// Square problem sizes (coefficients per input) the crossovers are measured at.
+static const int cal_sizes[CAL_SIZES] = {16, 64, 256, 1024, 4096, 16384, 65536};
+
+typedef struct {
+    int size;
+    poly_engine_t engine;
+    int threads;
+    double seconds;
+} cal_entry_t;
+
+static cal_entry_t cal_entries[CAL_MAX_ENTRIES];
+static int cal_count = 0;
+static int cal_state = -1;          // -1 not looked for yet, 0 no file, 1 loaded
+static pthread_once_t cal_once = PTHREAD_ONCE_INIT;
+
+static const char *engine_names[POLY_ENGINE_COUNT] = {"serial", "simd", "threaded", "ntt"};
+
+const char *poly_engine_name(poly_engine_t engine)
+{
+    return engine >= 0 && engine < POLY_ENGINE_COUNT ? engine_names[engine] : "unknown";
+}
+
+int *multiply_hybrid(const int *poly1, int deg1, const int *poly2, int deg2, int threads, simd_kernel_fn kernel)
+{
+    int result_len = deg1 + deg2 + 1;
+    int *starts = (int *)malloc((size_t)(threads + 1) * sizeof(int));
+    int **partials = (int **)malloc((size_t)threads * sizeof(int *));
+    int *result = (int *)malloc((size_t)result_len * sizeof(int));
+    if (!starts || !partials || !result) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    for (int t = 0; t <= threads; ++t) {
+        starts[t] = (int)((long long)(deg1 + 1) * t / threads);
+    }
+
+    #pragma omp parallel num_threads(threads)
+    {
+        // A partial product only covers outputs [start, end + deg2].
+        #pragma omp for schedule(static, 1)
+        for (int t = 0; t < threads; ++t) {
+            int rows = starts[t + 1] - starts[t];
+            partials[t] = NULL;
+            if (rows > 0) {
+                partials[t] = (int *)calloc((size_t)(rows + deg2), sizeof(int));
+                if (!partials[t]) {
+                    perror("calloc");
+                    exit(EXIT_FAILURE);
+                }
+                kernel(poly1 + starts[t], rows - 1, poly2, deg2, partials[t]);
+            }
+        }
+
+        // Each work item sums one slice of k over the partials that overlap it.
+        #pragma omp for schedule(static)
+        for (int kb = 0; kb < result_len; kb += REDUCE_SLICE) {
+            int ke = (kb + REDUCE_SLICE < result_len) ? kb + REDUCE_SLICE : result_len;
+            for (int k = kb; k < ke; ++k) {
+                result[k] = 0;
+            }
+            for (int t = 0; t < threads; ++t) {
+                if (!partials[t]) continue;
+                int lo = (kb > starts[t]) ? kb : starts[t];
+                int hi = (ke < starts[t + 1] + deg2) ? ke : starts[t + 1] + deg2;
+                const int *part = partials[t];
+                int offset = starts[t];
+                #pragma omp simd
+                for (int k = lo; k < hi; ++k) {
+                    result[k] += part[k - offset];
+                }
+            }
+        }
+    }
+
+    for (int t = 0; t < threads; ++t) {
+        free(partials[t]);
+    }
+    free(partials);
+    free(starts);
+    return result;
+}
+
+int *poly_multiply_plan(const int *poly1, int deg1, const int *poly2, int deg2, poly_plan_t plan)
+{
+    switch (plan.engine) {
+    case POLY_ENGINE_SIMD: {
+        int *result = (int *)calloc((size_t)deg1 + deg2 + 1, sizeof(int));
+        if (!result) {
+            perror("calloc");
+            exit(EXIT_FAILURE);
+        }
+        best_simd_kernel()(poly1, deg1, poly2, deg2, result);
+        return result;
+    }
+    case POLY_ENGINE_THREADED:
+        return multiply_hybrid(poly1, deg1, poly2, deg2, plan.threads, best_simd_kernel());
+    case POLY_ENGINE_NTT:
+        return multiply_ntt(poly1, deg1, poly2, deg2, plan.threads);
+    default:
+        return multiply_sequential(poly1, deg1, poly2, deg2);
+    }
+}
+
+const char *poly_calibration_path(void)
+{
+    static char path[4096];
+    const char *env = getenv("POLY_CALIBRATION");
+    if (env && *env) return env;
+    const char *home = getenv("HOME");
+    snprintf(path, sizeof(path), "%s/.poly_calibration", home ? home : ".");
+    return path;
+}
+
+int poly_load_calibration(const char *path)
+{
+    if (!path) path = poly_calibration_path();
+    FILE *f = fopen(path, "r");
+    cal_state = 0;
+    if (!f) return -1;
+
+    char line[256], name[32];
+    int size, threads;
+    double seconds;
+    cal_count = 0;
+    while (fgets(line, sizeof(line), f) && cal_count < CAL_MAX_ENTRIES) {
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%d %31s %d %lf", &size, name, &threads, &seconds) != 4) continue;
+        for (int e = 0; e < POLY_ENGINE_COUNT; ++e) {
+            if (strcmp(name, engine_names[e]) == 0 && threads > 0 && seconds > 0) {
+                cal_entries[cal_count++] = (cal_entry_t){size, (poly_engine_t)e, threads, seconds};
+            }
+        }
+    }
+    fclose(f);
+    cal_state = cal_count > 0;
+    return cal_state ? 0 : -1;
+}
+
+// L log2 L for len product coefficients, without the power-of-two steps so that
+// predictions change smoothly with the shape.
+static double ntt_cost(double len)
+{
+    return len * log2(len > 2 ? len : 2);
+}
+
+// Fixed thresholds for hosts that were never calibrated. The direct engines cost
+// (deg1 + 1)(deg2 + 1) mul-adds but NTT grows with deg1 + deg2, so a long poly1 times a
+// short poly2 stays on the direct kernels however much work it is.
+static poly_plan_t default_plan(int deg1, int deg2, int max_threads)
+{
+    double work = ((double)deg1 + 1) * ((double)deg2 + 1);
+    double n = sqrt(work);
+    if (n < 64) return (poly_plan_t){POLY_ENGINE_SERIAL, 1};
+    int threaded = n >= 2048 && max_threads > 1;
+    if (work >= (threaded ? NTT_RATIO_THREADED : NTT_RATIO) * ntt_cost((double)deg1 + deg2 + 1)) {
+        return (poly_plan_t){POLY_ENGINE_NTT, threaded ? max_threads : 1};
+    }
+    return threaded ? (poly_plan_t){POLY_ENGINE_THREADED, max_threads} : (poly_plan_t){POLY_ENGINE_SIMD, 1};
+}
+
+// Largest calibrated size not above n, or the smallest one.
+static int cal_bucket(double n)
+{
+    int bucket = cal_sizes[0];
+    for (int s = 0; s < CAL_SIZES; ++s) {
+        if (cal_sizes[s] <= n) bucket = cal_sizes[s];
+    }
+    return bucket;
+}
+
+// Lazy load of the default file, done once even when the first poly_plan() calls race.
+static void load_default_calibration(void)
+{
+    if (cal_state < 0) poly_load_calibration(NULL);
+}
+
+// Calibration only has squares, so each engine is looked up at the square of its own
+// cost: the direct engines at the geometric mean length (same mul-adds), NTT at the
+// arithmetic mean (same transform length). The time measured at the largest size not
+// above that is scaled by the cost ratio, and the fastest prediction wins.
+poly_plan_t poly_plan(int deg1, int deg2, int max_threads)
+{
+    if (max_threads <= 0) max_threads = omp_get_max_threads();
+    pthread_once(&cal_once, load_default_calibration);
+
+    if (cal_state != 1) return default_plan(deg1, deg2, max_threads);
+
+    double work = ((double)deg1 + 1) * ((double)deg2 + 1);
+    double len = (double)deg1 + deg2 + 1;
+    int direct_bucket = cal_bucket(sqrt(work));
+    int ntt_bucket = cal_bucket((len + 1) / 2);
+
+    poly_plan_t best = default_plan(deg1, deg2, max_threads);
+    double best_seconds = 0;
+    for (int e = 0; e < cal_count; ++e) {
+        const cal_entry_t *c = &cal_entries[e];
+        int ntt = c->engine == POLY_ENGINE_NTT;
+        if (c->size != (ntt ? ntt_bucket : direct_bucket) || c->threads > max_threads) continue;
+        double seconds = ntt ? c->seconds * ntt_cost(len) / ntt_cost(2.0 * c->size - 1)
+                             : c->seconds * work / ((double)c->size * c->size);
+        if (best_seconds == 0 || seconds < best_seconds) {
+            best = (poly_plan_t){c->engine, c->threads};
+            best_seconds = seconds;
+        }
+    }
+    return best;
+}
+
+int *poly_multiply_threads(const int *poly1, int deg1, const int *poly2, int deg2, int max_threads)
+{
+    return poly_multiply_plan(poly1, deg1, poly2, deg2, poly_plan(deg1, deg2, max_threads));
+}
+
+int *poly_multiply(const int *poly1, int deg1, const int *poly2, int deg2)
+{
+    return poly_multiply_threads(poly1, deg1, poly2, deg2, 0);
+}
+
+static double time_plan(const int *poly1, const int *poly2, int deg, poly_plan_t plan)
+{
+    double best = 0, total = 0;
+    for (int r = 0; r < CAL_MAX_REPEATS && (r == 0 || total < CAL_MIN_SECONDS); ++r) {
+        double start = now_seconds();
+        int *result = poly_multiply_plan(poly1, deg, poly2, deg, plan);
+        double elapsed = now_seconds() - start;
+        free(result);
+        total += elapsed;
+        if (r == 0 || elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+int poly_calibrate(const char *path, int max_threads)
+{
+    if (!path) path = poly_calibration_path();
+    if (max_threads <= 0) max_threads = omp_get_max_threads();
+
+    // Thread counts 1, 2, 4, ... below max_threads, then max_threads itself.
+    int thread_steps[32], steps = 0;
+    for (int t = 1; t < max_threads && steps < 31; t *= 2) {
+        thread_steps[steps++] = t;
+    }
+    thread_steps[steps++] = max_threads;
+
+    // dropped[e][k]: a quadratic configuration that already lost to NTT by more than
+    // CAL_PRUNE at a smaller size. NTT only pulls further ahead as the size grows.
+    int dropped[POLY_ENGINE_COUNT][32] = {{0}};
+    cal_count = 0;
+
+    for (int s = 0; s < CAL_SIZES; ++s) {
+        int deg = cal_sizes[s] - 1;
+        int *poly1 = create_random_polynomial(deg);
+        int *poly2 = create_random_polynomial(deg);
+        int first = cal_count;
+        double best_ntt = 0;
+
+        for (int e = 0; e < POLY_ENGINE_COUNT; ++e) {
+            int single = e == POLY_ENGINE_SERIAL || e == POLY_ENGINE_SIMD;
+            for (int k = 0; k < (single ? 1 : steps) && cal_count < CAL_MAX_ENTRIES; ++k) {
+                if (dropped[e][k]) continue;
+                poly_plan_t plan = {(poly_engine_t)e, thread_steps[k]};
+                double seconds = time_plan(poly1, poly2, deg, plan);
+                cal_entries[cal_count++] = (cal_entry_t){cal_sizes[s], plan.engine, plan.threads, seconds};
+                if (e == POLY_ENGINE_NTT && (best_ntt == 0 || seconds < best_ntt)) best_ntt = seconds;
+            }
+        }
+        for (int c = first; c < cal_count; ++c) {
+            if (cal_entries[c].engine != POLY_ENGINE_NTT && cal_entries[c].seconds > CAL_PRUNE * best_ntt) {
+                for (int k = 0; k < steps; ++k) {
+                    if (thread_steps[k] == cal_entries[c].threads) dropped[cal_entries[c].engine][k] = 1;
+                }
+            }
+        }
+        free(poly1);
+        free(poly2);
+    }
+    cal_state = 1;
+
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    fprintf(f, "# poly_multiply calibration: size engine threads seconds\n");
+    for (int c = 0; c < cal_count; ++c) {
+        fprintf(f, "%d %s %d %.9f\n", cal_entries[c].size, engine_names[cal_entries[c].engine],
+                cal_entries[c].threads, cal_entries[c].seconds);
+    }
+    fclose(f);
+    return 0;
+}
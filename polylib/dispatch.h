@@ -0,0 +1,46 @@
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#include "simd.h"
+
+// Single entry point that picks an engine and a thread count per call from
+// crossover points measured on the host by poly_calibrate(). Without a
+// calibration file it falls back to fixed size thresholds.
+typedef enum {
+    POLY_ENGINE_SERIAL,     // reference row loop, no start-up cost at all
+    POLY_ENGINE_SIMD,       // widest SIMD kernel on the calling thread
+    POLY_ENGINE_THREADED,   // OpenMP row ranges, SIMD kernel per thread
+    POLY_ENGINE_NTT,        // O(n log n) transforms, see ntt.h
+    POLY_ENGINE_COUNT
+} poly_engine_t;
+
+typedef struct {
+    poly_engine_t engine;
+    int threads;
+} poly_plan_t;
+
+const char *poly_engine_name(poly_engine_t engine);
+
+// max_threads <= 0 allows the OpenMP default thread count.
+poly_plan_t poly_plan(int deg1, int deg2, int max_threads);
+
+int *poly_multiply(const int *poly1, int deg1, const int *poly2, int deg2);
+int *poly_multiply_threads(const int *poly1, int deg1, const int *poly2, int deg2, int max_threads);
+int *poly_multiply_plan(const int *poly1, int deg1, const int *poly2, int deg2, poly_plan_t plan);
+
+// Threaded engine: contiguous poly1 row ranges per thread, each run through kernel
+// into a partial buffer, then summed one output slice at a time.
+int *multiply_hybrid(const int *poly1, int deg1, const int *poly2, int deg2, int threads, simd_kernel_fn kernel);
+
+// Calibration file: $POLY_CALIBRATION, else $HOME/.poly_calibration.
+const char *poly_calibration_path(void);
+
+// Times every engine and thread count on a ladder of sizes and writes the
+// results to path (NULL for the default). Returns 0 on success.
+int poly_calibrate(const char *path, int max_threads);
+
+// Replaces the crossover table with the one in path (NULL for the default).
+// Returns 0 on success; poly_plan() loads the default file lazily.
+int poly_load_calibration(const char *path);
+
+#endif
@@ -0,0 +1,100 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "incremental.h"
+#include "dispatch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+
+#define LIVE_SLICE 2048             // output coefficients per work item
+#define LIVE_PARALLEL_WORK 65536    // mul-adds below which a batch stays on the calling thread
+
+static int *copy_poly(const int *poly, int degree)
+{
+    int *copy = (int *)malloc(((size_t)degree + 1) * sizeof(int));
+    if (!copy) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(copy, poly, ((size_t)degree + 1) * sizeof(int));
+    return copy;
+}
+
+void poly_live_init(poly_live_t *live, const int *poly1, int deg1, const int *poly2, int deg2,
+                    const int *product, int threads)
+{
+    live->poly1 = copy_poly(poly1, deg1);
+    live->poly2 = copy_poly(poly2, deg2);
+    live->deg1 = deg1;
+    live->deg2 = deg2;
+    live->threads = threads > 0 ? threads : omp_get_max_threads();
+    live->product = product ? copy_poly(product, deg1 + deg2)
+                            : poly_multiply_threads(poly1, deg1, poly2, deg2, live->threads);
+    live->scratch = NULL;
+    live->scratch_len = 0;
+}
+
+void poly_live_update(poly_live_t *live, int which, const poly_update_t *updates, int count)
+{
+    int *target = which == 1 ? live->poly1 : live->poly2;
+    int target_deg = which == 1 ? live->deg1 : live->deg2;
+    const int *other = which == 1 ? live->poly2 : live->poly1;
+    int other_deg = which == 1 ? live->deg2 : live->deg1;
+
+    if (live->scratch_len < 2 * count) {
+        free(live->scratch);
+        live->scratch_len = 2 * count;
+        live->scratch = (int *)malloc((size_t)live->scratch_len * sizeof(int));
+        if (!live->scratch) {
+            perror("malloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    // Deltas against the value each coefficient has at that point of the batch.
+    int *index = live->scratch, *delta = live->scratch + count;
+    int k = 0;
+    for (int u = 0; u < count; ++u) {
+        int i = updates[u].index;
+        if (i < 0 || i > target_deg) {
+            fprintf(stderr, "poly_live_update: index %d outside poly%d of degree %d\n", i, which, target_deg);
+            exit(EXIT_FAILURE);
+        }
+        int d = updates[u].value - target[i];
+        target[i] = updates[u].value;
+        if (d != 0) {
+            index[k] = i;
+            delta[k] = d;
+            ++k;
+        }
+    }
+
+    int out_len = live->deg1 + live->deg2 + 1;
+    int slices = (out_len + LIVE_SLICE - 1) / LIVE_SLICE;
+    long long work = (long long)k * (other_deg + 1);
+    int *product = live->product;
+    #pragma omp parallel for num_threads(live->threads) schedule(static) if (work >= LIVE_PARALLEL_WORK)
+    for (int s = 0; s < slices; ++s) {
+        int ks = s * LIVE_SLICE;
+        int ke = (ks + LIVE_SLICE - 1 < out_len - 1) ? ks + LIVE_SLICE - 1 : out_len - 1;
+        for (int u = 0; u < k; ++u) {
+            int i = index[u], d = delta[u];
+            int j_lo = (ks - i > 0) ? ks - i : 0;
+            int j_hi = (ke - i < other_deg) ? ke - i : other_deg;
+            int *res = product + i;
+            #pragma omp simd
+            for (int j = j_lo; j <= j_hi; ++j) {
+                res[j] += d * other[j];
+            }
+        }
+    }
+}
+
+void poly_live_free(poly_live_t *live)
+{
+    free(live->poly1);
+    free(live->poly2);
+    free(live->product);
+    free(live->scratch);
+    memset(live, 0, sizeof(*live));
+}
@@ -0,0 +1,33 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+// A product kept up to date while its factors change. Setting poly1[i] to a new value
+// moves the product by delta * x^i * poly2, so an update of k coefficients costs
+// O(k * n) instead of the O(n^2) of multiplying again. Batches are applied in one pass,
+// split over OpenMP threads by output range so no two threads write the same sum.
+typedef struct {
+    int index;
+    int value;
+} poly_update_t;
+
+typedef struct {
+    int *poly1, *poly2;         // private copies, always in step with product
+    int deg1, deg2;
+    int *product;               // deg1 + deg2 + 1 coefficients
+    int threads;
+    int *scratch;               // resolved (index, delta) pairs of the current batch
+    int scratch_len;
+} poly_live_t;
+
+// Copies both factors. product may be their existing product, or NULL to compute it.
+// threads <= 0 uses the OpenMP default.
+void poly_live_init(poly_live_t *live, const int *poly1, int deg1, const int *poly2, int deg2,
+                    const int *product, int threads);
+
+// Sets coefficients of poly1 (which = 1) or poly2 (which = 2) in order, so a later
+// entry for the same index wins. Indices outside the polynomial are an error.
+void poly_live_update(poly_live_t *live, int which, const poly_update_t *updates, int count);
+
+void poly_live_free(poly_live_t *live);
+
+#endif
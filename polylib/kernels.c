@@ -0,0 +1,236 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "kernels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+
+void multiply_blocked_kernel(const int *poly1, int i_start, int i_end, const int *poly2, int deg2, int *result)
+{
+    for (int ib = i_start; ib <= i_end; ib += TILE_I) {
+        int ie = (ib + TILE_I - 1 < i_end) ? ib + TILE_I - 1 : i_end;
+        for (int jb = 0; jb <= deg2; jb += TILE_J) {
+            int je = (jb + TILE_J - 1 < deg2) ? jb + TILE_J - 1 : deg2;
+            for (int i = ib; i <= ie; ++i) {
+                int a = poly1[i];
+                int *res = result + i;
+                #pragma omp simd
+                for (int j = jb; j <= je; ++j) {
+                    res[j] += a * poly2[j];
+                }
+            }
+        }
+    }
+}
+
+int *multiply_blocked(const int *poly1, int deg1, const int *poly2, int deg2)
+{
+    int *result = (int *)calloc((size_t)(deg1 + deg2 + 1), sizeof(int));
+    if (!result) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+    multiply_blocked_kernel(poly1, 0, deg1, poly2, deg2, result);
+    return result;
+}
+
+void multiply_output_range(const int *poly1, int deg1, const int *poly2, int deg2, int k_start, int k_end, int *result)
+{
+    for (int k = k_start; k <= k_end; ++k) {
+        result[k] = 0;
+    }
+    accumulate_output_range(poly1, 0, deg1, poly2, deg2, k_start, k_end, result + k_start);
+}
+
+void accumulate_output_range(const int *poly1, int i_start, int i_end, const int *poly2, int deg2,
+                             int k_start, int k_end, int *window)
+{
+    int i_lo = (k_start - deg2 > i_start) ? k_start - deg2 : i_start;
+    int i_hi = (k_end < i_end) ? k_end : i_end;
+
+    for (int i = i_lo; i <= i_hi; ++i) {
+        int a = poly1[i];
+        int j_lo = (k_start - i > 0) ? k_start - i : 0;
+        int j_hi = (k_end - i < deg2) ? k_end - i : deg2;
+        int *res = window + (i + j_lo - k_start);
+        const int *p2 = poly2 + j_lo;
+        #pragma omp simd
+        for (int j = 0; j <= j_hi - j_lo; ++j) {
+            res[j] += a * p2[j];
+        }
+    }
+}
+
+void partition_outputs(int deg1, int deg2, int parts, int *bounds)
+{
+    long long total = (long long)(deg1 + 1) * (deg2 + 1);
+    long long done = 0;
+    int p = 1;
+
+    bounds[0] = 0;
+    for (int k = 0; k <= deg1 + deg2 && p < parts; ++k) {
+        int lo = (k - deg2 > 0) ? k - deg2 : 0;
+        int hi = (k < deg1) ? k : deg1;
+        done += hi - lo + 1;
+        while (p < parts && done * parts >= total * p) {
+            bounds[p++] = k + 1;
+        }
+    }
+    while (p <= parts) {
+        bounds[p++] = deg1 + deg2 + 1;
+    }
+}
+
+// Karatsuba works in unsigned arithmetic: the intermediate sums can overflow int,
+// but the final coefficients are exact modulo 2^32 and fit in int. The base kernels
+// wrap the same way, so they are used unchanged on the unsigned operands.
+typedef struct {
+    int threshold;
+    simd_kernel_fn base;
+} karatsuba_cfg_t;
+
+// Scratch needed by karatsuba_serial for length n (the recursion reuses it level by level).
+static size_t karatsuba_scratch_len(int n, int threshold)
+{
+    size_t len = 1;
+    while (n > threshold) {
+        int h = n - n / 2;
+        len += 4 * (size_t)h;
+        n = h;
+    }
+    return len;
+}
+
+// Sums of the low (length m) and high (length h >= m) halves of a and b.
+static void karatsuba_sums(const unsigned *a, const unsigned *b, int m, int h, unsigned *sa, unsigned *sb)
+{
+    for (int i = 0; i < m; ++i) {
+        sa[i] = a[i] + a[m + i];
+        sb[i] = b[i] + b[m + i];
+    }
+    if (h > m) {
+        sa[m] = a[2 * m];
+        sb[m] = b[2 * m];
+    }
+}
+
+// out holds z0 in [0, 2m-1) and z2 in [2m, 2m+2h-1); add z1 - z0 - z2 at offset m.
+static void karatsuba_combine(unsigned *out, unsigned *z1, int m, int h)
+{
+    for (int i = 0; i < 2 * m - 1; ++i) {
+        z1[i] -= out[i];
+    }
+    for (int i = 0; i < 2 * h - 1; ++i) {
+        z1[i] -= out[2 * m + i];
+    }
+    for (int i = 0; i < 2 * h - 1; ++i) {
+        out[m + i] += z1[i];
+    }
+}
+
+// Product of two length-n operands into out[0 .. 2n-2].
+static void karatsuba_serial(const unsigned *a, const unsigned *b, int n, unsigned *out, unsigned *scratch,
+                             const karatsuba_cfg_t *cfg)
+{
+    if (n <= cfg->threshold) {
+        memset(out, 0, (size_t)(2 * n - 1) * sizeof(unsigned));
+        cfg->base((const int *)a, n - 1, (const int *)b, n - 1, (int *)out);
+        return;
+    }
+
+    int m = n / 2;
+    int h = n - m;
+    unsigned *sa = scratch;
+    unsigned *sb = sa + h;
+    unsigned *z1 = sb + h;
+    unsigned *next = z1 + 2 * h;
+
+    karatsuba_serial(a, b, m, out, next, cfg);                  // z0 = low * low
+    out[2 * m - 1] = 0;
+    karatsuba_serial(a + m, b + m, h, out + 2 * m, next, cfg);  // z2 = high * high
+
+    karatsuba_sums(a, b, m, h, sa, sb);
+    karatsuba_serial(sa, sb, h, z1, next, cfg);                 // z1 = (low + high) * (low + high)
+    karatsuba_combine(out, z1, m, h);
+}
+
+// Same recursion as karatsuba_serial with the three sub-products as tasks.
+// Each task level owns its own temporaries.
+static void karatsuba_parallel(const unsigned *a, const unsigned *b, int n, unsigned *out, const karatsuba_cfg_t *cfg)
+{
+    if (n <= KARATSUBA_TASK_CUTOFF || n <= cfg->threshold) {
+        unsigned *scratch = (unsigned *)malloc(karatsuba_scratch_len(n, cfg->threshold) * sizeof(unsigned));
+        if (!scratch) {
+            perror("malloc scratch");
+            exit(EXIT_FAILURE);
+        }
+        karatsuba_serial(a, b, n, out, scratch, cfg);
+        free(scratch);
+        return;
+    }
+
+    int m = n / 2;
+    int h = n - m;
+    unsigned *sa = (unsigned *)malloc(4 * (size_t)h * sizeof(unsigned));
+    if (!sa) {
+        perror("malloc karatsuba");
+        exit(EXIT_FAILURE);
+    }
+    unsigned *sb = sa + h;
+    unsigned *z1 = sb + h;
+
+    #pragma omp task
+    karatsuba_parallel(a, b, m, out, cfg);
+
+    #pragma omp task
+    karatsuba_parallel(a + m, b + m, h, out + 2 * m, cfg);
+
+    #pragma omp task
+    {
+        karatsuba_sums(a, b, m, h, sa, sb);
+        karatsuba_parallel(sa, sb, h, z1, cfg);
+    }
+
+    #pragma omp taskwait
+    out[2 * m - 1] = 0;
+    karatsuba_combine(out, z1, m, h);
+    free(sa);
+}
+
+int *multiply_karatsuba(const int *poly1, int deg1, const int *poly2, int deg2,
+                        int threshold, simd_kernel_fn base, int threads)
+{
+    karatsuba_cfg_t cfg = {threshold > 0 ? threshold : 1, base};
+    int n = (deg1 > deg2 ? deg1 : deg2) + 1;
+    unsigned *a = (unsigned *)calloc((size_t)n, sizeof(unsigned));
+    unsigned *b = (unsigned *)calloc((size_t)n, sizeof(unsigned));
+    int *result = (int *)malloc((size_t)(2 * n - 1) * sizeof(int));
+    if (!a || !b || !result) {
+        perror("malloc karatsuba");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(a, poly1, (size_t)(deg1 + 1) * sizeof(int));
+    memcpy(b, poly2, (size_t)(deg2 + 1) * sizeof(int));
+
+    if (threads <= 1) {
+        unsigned *scratch = (unsigned *)malloc(karatsuba_scratch_len(n, cfg.threshold) * sizeof(unsigned));
+        if (!scratch) {
+            perror("malloc scratch");
+            exit(EXIT_FAILURE);
+        }
+        karatsuba_serial(a, b, n, (unsigned *)result, scratch, &cfg);
+        free(scratch);
+    }
+    else {
+        #pragma omp parallel num_threads(threads)
+        {
+            #pragma omp single
+            karatsuba_parallel(a, b, n, (unsigned *)result, &cfg);
+        }
+    }
+
+    free(a);
+    free(b);
+    return result;
+}
@@ -0,0 +1,37 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include "simd.h"
+
+// Building blocks of the driver engines: cache-blocked rows, output-range ownership and
+// Karatsuba. Results wrap modulo 2^32 like every other int kernel here.
+#define TILE_I 256                  // poly1 rows per tile
+#define TILE_J 2048                 // poly2 coefficients per tile (8 KB, plus a TILE_I + TILE_J result window)
+#define KARATSUBA_TASK_CUTOFF 4096  // below this length Karatsuba recurses without spawning tasks
+
+// Accumulates poly1[i_start..i_end] * poly2 into result one TILE_I x TILE_J tile at a time,
+// so the poly2 tile and the result window it touches stay in L1 across all rows of the tile.
+void multiply_blocked_kernel(const int *poly1, int i_start, int i_end, const int *poly2, int deg2, int *result);
+
+int *multiply_blocked(const int *poly1, int deg1, const int *poly2, int deg2);
+
+// Computes result[k_start..k_end] directly: every row i that reaches the range adds the
+// part of its products that lands inside it, so nothing outside the range is written.
+void multiply_output_range(const int *poly1, int deg1, const int *poly2, int deg2, int k_start, int k_end, int *result);
+
+// Adds the products of rows poly1[i_start..i_end] that land in outputs [k_start, k_end] to
+// window[0 .. k_end - k_start], for callers that hold only that window of the result.
+void accumulate_output_range(const int *poly1, int i_start, int i_end, const int *poly2, int deg2,
+                             int k_start, int k_end, int *window);
+
+// Splits the output coefficients into parts contiguous ranges with about the same number
+// of products each; range t is [bounds[t], bounds[t + 1]).
+void partition_outputs(int deg1, int deg2, int parts, int *bounds);
+
+// Both operands are zero-padded to n = max(deg1, deg2) + 1, so the result has 2n - 1
+// coefficients. Lengths up to threshold go through base (any simd_kernel_fn). With
+// threads > 1 the three sub-products above KARATSUBA_TASK_CUTOFF are OpenMP tasks.
+int *multiply_karatsuba(const int *poly1, int deg1, const int *poly2, int deg2,
+                        int threshold, simd_kernel_fn base, int threads);
+
+#endif
@@ -0,0 +1,95 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "multipoint.h"
+#include "dispatch.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+
+#define TREE_TASK_CUTOFF 8          // subtrees with fewer factors are merged without new tasks
+
+void poly_eval_points(const int *poly, int degree, const int *points, int count, int *values, int threads)
+{
+    if (threads <= 0) threads = omp_get_max_threads();
+    int groups = (count + EVAL_LANES - 1) / EVAL_LANES;
+
+    #pragma omp parallel for num_threads(threads) schedule(static)
+    for (int g = 0; g < groups; ++g) {
+        int first = g * EVAL_LANES;
+        int lanes = count - first < EVAL_LANES ? count - first : EVAL_LANES;
+        uint32_t x[EVAL_LANES] = {0}, acc[EVAL_LANES] = {0};
+        for (int l = 0; l < lanes; ++l) {
+            x[l] = (uint32_t)points[first + l];
+        }
+        // Full-width lanes even for the last group, so the loop always has the same shape.
+        for (int i = degree; i >= 0; --i) {
+            uint32_t c = (uint32_t)poly[i];
+            #pragma omp simd
+            for (int l = 0; l < EVAL_LANES; ++l) {
+                acc[l] = acc[l] * x[l] + c;
+            }
+        }
+        for (int l = 0; l < lanes; ++l) {
+            values[first + l] = (int)acc[l];
+        }
+    }
+}
+
+static int *copy_poly(const int *poly, int degree)
+{
+    int *copy = (int *)malloc(((size_t)degree + 1) * sizeof(int));
+    if (!copy) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(copy, poly, ((size_t)degree + 1) * sizeof(int));
+    return copy;
+}
+
+// Product of factors [lo, hi); share is the number of threads this subtree may use.
+static int *tree_merge(int *const *polys, const int *degrees, int lo, int hi, int share, int *degree)
+{
+    if (hi - lo == 1) {
+        *degree = degrees[lo];
+        return copy_poly(polys[lo], degrees[lo]);
+    }
+    int mid = lo + (hi - lo) / 2;
+    int half = share / 2 > 0 ? share / 2 : 1;
+    int deg_left, deg_right;
+    int *left, *right;
+
+    #pragma omp task shared(left, deg_left) if (hi - lo >= TREE_TASK_CUTOFF)
+    left = tree_merge(polys, degrees, lo, mid, half, &deg_left);
+    right = tree_merge(polys, degrees, mid, hi, share - half > 0 ? share - half : 1, &deg_right);
+    #pragma omp taskwait
+
+    int *product = poly_multiply_plan(left, deg_left, right, deg_right, poly_plan(deg_left, deg_right, share));
+    *degree = deg_left + deg_right;
+    free(left);
+    free(right);
+    return product;
+}
+
+int *poly_product_tree(int *const *polys, const int *degrees, int count, int *degree, int threads)
+{
+    if (threads <= 0) threads = omp_get_max_threads();
+    if (count <= 0) {
+        int one = 1;
+        *degree = 0;
+        return copy_poly(&one, 0);
+    }
+
+    // The merges near the root run their own thread teams from inside a task.
+    int levels = omp_get_max_active_levels();
+    omp_set_max_active_levels(levels > 2 ? levels : 2);
+
+    int *product = NULL;
+    #pragma omp parallel num_threads(threads)
+    #pragma omp single
+    product = tree_merge(polys, degrees, 0, count, threads, degree);
+
+    omp_set_max_active_levels(levels);
+    return product;
+}
@@ -0,0 +1,20 @@
+#ifndef MULTIPOINT_H
+#define MULTIPOINT_H
+
+// Evaluation at many points and products of many factors. Values wrap modulo 2^32 like
+// the int multiply kernels, so evaluating a product at x gives the product of the
+// factors' values at x, which is also how the product tree is checked cheaply.
+#define EVAL_LANES 16               // points advanced together through one Horner pass
+
+// values[p] = poly(points[p]). Points go through Horner EVAL_LANES at a time, one
+// vector lane each, and the groups are spread over threads (<= 0 for the default).
+void poly_eval_points(const int *poly, int degree, const int *points, int count, int *values, int threads);
+
+// Product of count factors, merged pairwise up a balanced tree. Each merge is an OpenMP
+// task and runs on the engine poly_plan() picks for its shape and its share of the
+// threads: one thread each near the leaves, where many merges run at once, and the whole
+// team for the last few. Stores the product's degree in *degree and returns it (the
+// constant 1 when count is 0).
+int *poly_product_tree(int *const *polys, const int *degrees, int count, int *degree, int threads);
+
+#endif
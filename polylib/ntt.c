@@ -0,0 +1,458 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "ntt.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <omp.h>
+#include <pthread.h>
+#include <immintrin.h>
+
+#define ROOT_CHUNK 4096         // Twiddles generated per pow_mod seed.
+
+#define AVX2 __attribute__((target("avx2")))
+
+typedef struct {
+    uint32_t p;
+    uint32_t g;         // primitive root mod p
+    uint32_t pinv;      // p^-1 mod 2^32
+    uint32_t r2;        // 2^64 mod p, maps x to its Montgomery form x * 2^32
+} ntt_prime_t;
+
+// All primes are below 2^31, so Montgomery products fit in 64 bits and
+// modular sums fit in 32 bits. Two primes cover |coefficient| < 1.8e18,
+// the third is only used for inputs that could exceed that.
+static ntt_prime_t primes[NTT_MAX_PRIMES] = {
+    {2013265921u, 31, 0, 0},    // 15 * 2^27 + 1
+    {1811939329u, 13, 0, 0},    // 27 * 2^26 + 1
+    {469762049u, 3, 0, 0},      //  7 * 2^26 + 1
+};
+
+static uint64_t inv_p1_mod_p2;
+static uint64_t inv_p1p2_mod_p3;
+static pthread_once_t primes_once = PTHREAD_ONCE_INIT;
+
+static uint32_t pow_mod(uint32_t base, uint64_t e, uint32_t p)
+{
+    uint64_t r = 1, b = base % p;
+    while (e) {
+        if (e & 1) r = r * b % p;
+        b = b * b % p;
+        e >>= 1;
+    }
+    return (uint32_t)r;
+}
+
+static void compute_primes(void)
+{
+    for (int k = 0; k < NTT_MAX_PRIMES; ++k) {
+        uint32_t p = primes[k].p;
+        uint32_t inv = p;               // Newton iteration, each step doubles the correct bits.
+        for (int it = 0; it < 5; ++it) {
+            inv *= 2 - p * inv;
+        }
+        uint64_t r = ((uint64_t)1 << 32) % p;
+        primes[k].r2 = (uint32_t)(r * r % p);
+        primes[k].pinv = inv;
+    }
+
+    uint64_t p1 = primes[0].p, p2 = primes[1].p, p3 = primes[2].p;
+    inv_p1_mod_p2 = pow_mod((uint32_t)(p1 % p2), p2 - 2, (uint32_t)p2);
+    inv_p1p2_mod_p3 = pow_mod((uint32_t)(p1 * p2 % p3), p3 - 2, (uint32_t)p3);
+}
+
+// Concurrent first callers (e.g. product-tree tasks) all wait until every constant is set.
+static void init_primes(void)
+{
+    pthread_once(&primes_once, compute_primes);
+}
+
+// Returns a * b * 2^-32 mod p for a, b < p.
+static inline uint32_t mont_mul(uint32_t a, uint32_t b, const ntt_prime_t *P)
+{
+    uint64_t t = (uint64_t)a * b;
+    uint32_t m = (uint32_t)t * P->pinv;
+    int64_t u = ((int64_t)t - (int64_t)((uint64_t)m * P->p)) >> 32;
+    return (uint32_t)(u < 0 ? u + P->p : u);
+}
+
+static inline uint32_t add_mod(uint32_t a, uint32_t b, uint32_t p)
+{
+    uint32_t s = a + b;
+    return s >= p ? s - p : s;
+}
+
+static inline uint32_t sub_mod(uint32_t a, uint32_t b, uint32_t p)
+{
+    return a >= b ? a - b : a + p - b;
+}
+
+static inline AVX2 __m256i add_mod_avx2(__m256i a, __m256i b, __m256i p)
+{
+    __m256i s = _mm256_add_epi32(a, b);
+    return _mm256_min_epu32(s, _mm256_sub_epi32(s, p));
+}
+
+static inline AVX2 __m256i sub_mod_avx2(__m256i a, __m256i b, __m256i p)
+{
+    __m256i d = _mm256_sub_epi32(a, b);
+    return _mm256_min_epu32(d, _mm256_add_epi32(d, p));
+}
+
+// Eight Montgomery products: even and odd lanes go through separate 32x32->64 multiplies.
+static inline AVX2 __m256i mont_mul_avx2(__m256i a, __m256i b, __m256i p, __m256i pinv)
+{
+    __m256i t_even = _mm256_mul_epu32(a, b);
+    __m256i t_odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+    __m256i mp_even = _mm256_mul_epu32(_mm256_mul_epu32(t_even, pinv), p);
+    __m256i mp_odd = _mm256_mul_epu32(_mm256_mul_epu32(t_odd, pinv), p);
+    __m256i u_even = _mm256_srli_epi64(_mm256_sub_epi64(t_even, mp_even), 32);
+    __m256i u_odd = _mm256_sub_epi64(t_odd, mp_odd);
+    __m256i u = _mm256_blend_epi32(u_even, u_odd, 0xAA);
+    __m256i neg = _mm256_cmpgt_epi32(_mm256_setzero_si256(), u);
+    return _mm256_add_epi32(u, _mm256_and_si256(neg, p));
+}
+
+// roots[h + j] = w_{2h}^j in Montgomery form for every power of two h < n,
+// where w is a primitive n-th root of unity. Must run inside a parallel region.
+static void build_roots(uint32_t *roots, int n, uint32_t w, const ntt_prime_t *P)
+{
+    int half = n / 2;
+    uint32_t w_mont = mont_mul(w, P->r2, P);
+
+    #pragma omp for schedule(static)
+    for (int c = 0; c < half; c += ROOT_CHUNK) {
+        uint32_t x = mont_mul(pow_mod(w, (uint64_t)c, P->p), P->r2, P);
+        int end = c + ROOT_CHUNK < half ? c + ROOT_CHUNK : half;
+        for (int j = c; j < end; ++j) {
+            roots[half + j] = x;
+            x = mont_mul(x, w_mont, P);
+        }
+    }
+
+    for (int h = half / 2; h >= 1; h /= 2) {
+        #pragma omp for schedule(static)
+        for (int j = 0; j < h; ++j) {
+            roots[h + j] = roots[2 * h + 2 * j];
+        }
+    }
+}
+
+static void load_residues(uint32_t *a, const int *poly, int deg, int n, uint32_t p)
+{
+    #pragma omp for schedule(static)
+    for (int i = 0; i < n; ++i) {
+        if (i > deg) {
+            a[i] = 0;
+        }
+        else {
+            int64_t r = (int64_t)poly[i] % p;
+            a[i] = (uint32_t)(r < 0 ? r + p : r);
+        }
+    }
+}
+
+// Decimation-in-frequency butterflies for one stage: natural order in, bit-reversed out.
+static void dif_stage(uint32_t *a, int n, int h, const uint32_t *roots, const ntt_prime_t *P)
+{
+    int log_h = __builtin_ctz((unsigned)h);
+
+    #pragma omp for schedule(static)
+    for (int b = 0; b < n / 2; ++b) {
+        int j = b & (h - 1);
+        int i = ((b >> log_h) << (log_h + 1)) + j;
+        uint32_t u = a[i];
+        uint32_t v = a[i + h];
+        a[i] = add_mod(u, v, P->p);
+        a[i + h] = mont_mul(sub_mod(u, v, P->p), roots[h + j], P);
+    }
+}
+
+static AVX2 void dif_stage_avx2(uint32_t *a, int n, int h, const uint32_t *roots, const ntt_prime_t *P)
+{
+    int log_h = __builtin_ctz((unsigned)h);
+    __m256i p = _mm256_set1_epi32((int)P->p);
+    __m256i pinv = _mm256_set1_epi32((int)P->pinv);
+
+    #pragma omp for schedule(static)
+    for (int b = 0; b < n / 2; b += 8) {
+        int j = b & (h - 1);
+        int i = ((b >> log_h) << (log_h + 1)) + j;
+        __m256i u = _mm256_loadu_si256((__m256i *)&a[i]);
+        __m256i v = _mm256_loadu_si256((__m256i *)&a[i + h]);
+        __m256i w = _mm256_loadu_si256((const __m256i *)&roots[h + j]);
+        _mm256_storeu_si256((__m256i *)&a[i], add_mod_avx2(u, v, p));
+        _mm256_storeu_si256((__m256i *)&a[i + h], mont_mul_avx2(sub_mod_avx2(u, v, p), w, p, pinv));
+    }
+}
+
+// Decimation-in-time butterflies for one stage: bit-reversed order in, natural out.
+static void dit_stage(uint32_t *a, int n, int h, const uint32_t *roots, const ntt_prime_t *P)
+{
+    int log_h = __builtin_ctz((unsigned)h);
+
+    #pragma omp for schedule(static)
+    for (int b = 0; b < n / 2; ++b) {
+        int j = b & (h - 1);
+        int i = ((b >> log_h) << (log_h + 1)) + j;
+        uint32_t u = a[i];
+        uint32_t v = mont_mul(a[i + h], roots[h + j], P);
+        a[i] = add_mod(u, v, P->p);
+        a[i + h] = sub_mod(u, v, P->p);
+    }
+}
+
+static AVX2 void dit_stage_avx2(uint32_t *a, int n, int h, const uint32_t *roots, const ntt_prime_t *P)
+{
+    int log_h = __builtin_ctz((unsigned)h);
+    __m256i p = _mm256_set1_epi32((int)P->p);
+    __m256i pinv = _mm256_set1_epi32((int)P->pinv);
+
+    #pragma omp for schedule(static)
+    for (int b = 0; b < n / 2; b += 8) {
+        int j = b & (h - 1);
+        int i = ((b >> log_h) << (log_h + 1)) + j;
+        __m256i u = _mm256_loadu_si256((__m256i *)&a[i]);
+        __m256i w = _mm256_loadu_si256((const __m256i *)&roots[h + j]);
+        __m256i v = mont_mul_avx2(_mm256_loadu_si256((__m256i *)&a[i + h]), w, p, pinv);
+        _mm256_storeu_si256((__m256i *)&a[i], add_mod_avx2(u, v, p));
+        _mm256_storeu_si256((__m256i *)&a[i + h], sub_mod_avx2(u, v, p));
+    }
+}
+
+// a[i] = a[i] * b[i] * scale * 2^-64, i.e. the pointwise product already divided by n.
+static void pointwise(uint32_t *a, const uint32_t *b, int n, uint32_t scale, const ntt_prime_t *P)
+{
+    #pragma omp for schedule(static)
+    for (int i = 0; i < n; ++i) {
+        a[i] = mont_mul(mont_mul(a[i], b[i], P), scale, P);
+    }
+}
+
+static AVX2 void pointwise_avx2(uint32_t *a, const uint32_t *b, int n, uint32_t scale, const ntt_prime_t *P)
+{
+    __m256i p = _mm256_set1_epi32((int)P->p);
+    __m256i pinv = _mm256_set1_epi32((int)P->pinv);
+    __m256i s = _mm256_set1_epi32((int)scale);
+
+    #pragma omp for schedule(static)
+    for (int i = 0; i < n; i += 8) {
+        __m256i x = _mm256_loadu_si256((__m256i *)&a[i]);
+        __m256i y = _mm256_loadu_si256((const __m256i *)&b[i]);
+        x = mont_mul_avx2(mont_mul_avx2(x, y, p, pinv), s, p, pinv);
+        _mm256_storeu_si256((__m256i *)&a[i], x);
+    }
+}
+
+// Stages with fewer than 8 butterflies per block, and hosts without AVX2, use the scalar loop.
+static void ntt_forward(uint32_t *a, int n, const uint32_t *roots, const ntt_prime_t *P, int use_avx2)
+{
+    for (int h = n / 2; h >= 1; h /= 2) {
+        if (use_avx2 && h >= 8) dif_stage_avx2(a, n, h, roots, P);
+        else dif_stage(a, n, h, roots, P);
+    }
+}
+
+static void ntt_inverse(uint32_t *a, int n, const uint32_t *iroots, const ntt_prime_t *P, int use_avx2)
+{
+    for (int h = 1; h < n; h *= 2) {
+        if (use_avx2 && h >= 8) dit_stage_avx2(a, n, h, iroots, P);
+        else dit_stage(a, n, h, iroots, P);
+    }
+}
+
+// Garner reconstruction from one residue per prime, reduced to int like the schoolbook sum.
+static int crt_values(uint64_t r1, uint64_t r2, uint64_t r3, int nprimes)
+{
+    uint64_t p1 = primes[0].p, p2 = primes[1].p;
+    uint64_t k2 = (r2 + p2 - r1 % p2) % p2 * inv_p1_mod_p2 % p2;
+    uint64_t x = r1 + p1 * k2;
+    uint64_t m = p1 * p2;
+
+    if (nprimes == 2) {
+        if (x > m / 2) x -= m;
+        return (int)(uint32_t)x;
+    }
+
+    uint64_t p3 = primes[2].p;
+    uint64_t k3 = (r3 + p3 - x % p3) % p3 * inv_p1p2_mod_p3 % p3;
+    unsigned __int128 big_x = x + (unsigned __int128)m * k3;
+    unsigned __int128 big_m = (unsigned __int128)m * p3;
+    if (big_x > big_m / 2) big_x -= big_m;
+    return (int)(uint32_t)big_x;
+}
+
+static int crt_combine(const uint32_t *residues, int n, int i, int nprimes)
+{
+    return crt_values(residues[i], residues[(size_t)n + i], nprimes > 2 ? residues[2 * (size_t)n + i] : 0, nprimes);
+}
+
+static uint64_t max_abs(const int *poly, int deg)
+{
+    uint64_t best = 0;
+    for (int i = 0; i <= deg; ++i) {
+        uint64_t v = poly[i] < 0 ? (uint64_t)(-(int64_t)poly[i]) : (uint64_t)poly[i];
+        if (v > best) best = v;
+    }
+    return best;
+}
+
+// Two primes suffice while every exact coefficient stays below p1 * p2 / 2.
+int ntt_primes_needed(uint64_t max1, uint64_t max2, int terms)
+{
+    unsigned __int128 bound = (unsigned __int128)max1 * max2 * (uint64_t)terms;
+    unsigned __int128 limit = (unsigned __int128)primes[0].p * primes[1].p / 2;
+    return bound < limit ? 2 : 3;
+}
+
+int *multiply_ntt(const int *poly1, int deg1, const int *poly2, int deg2, int threads)
+{
+    int result_len = deg1 + deg2 + 1;
+    int log_n = 0;
+    while ((1L << log_n) < result_len) {
+        ++log_n;
+    }
+    if (log_n > NTT_MAX_LOG) {
+        fprintf(stderr, "multiply_ntt: product length %d exceeds 2^%d\n", result_len, NTT_MAX_LOG);
+        exit(EXIT_FAILURE);
+    }
+    int n = 1 << log_n;
+
+    init_primes();
+    int nprimes = ntt_primes_needed(max_abs(poly1, deg1), max_abs(poly2, deg2), (deg1 < deg2 ? deg1 : deg2) + 1);
+    int use_avx2 = __builtin_cpu_supports("avx2") && n >= 8;
+    if (threads <= 0) threads = omp_get_max_threads();
+
+    uint32_t *fa = (uint32_t *)malloc((size_t)nprimes * n * sizeof(uint32_t));
+    uint32_t *fb = (uint32_t *)malloc((size_t)n * sizeof(uint32_t));
+    uint32_t *roots = (uint32_t *)malloc((size_t)n * sizeof(uint32_t));
+    uint32_t *iroots = (uint32_t *)malloc((size_t)n * sizeof(uint32_t));
+    int *result = (int *)malloc((size_t)result_len * sizeof(int));
+    if (!fa || !fb || !roots || !iroots || !result) {
+        perror("malloc ntt");
+        exit(EXIT_FAILURE);
+    }
+
+    #pragma omp parallel num_threads(threads)
+    {
+        for (int k = 0; k < nprimes; ++k) {
+            const ntt_prime_t *P = &primes[k];
+            uint32_t *a = fa + (size_t)k * n;
+            uint32_t w = pow_mod(P->g, (P->p - 1) >> log_n, P->p);
+            uint32_t n_inv = pow_mod((uint32_t)n, P->p - 2, P->p);
+            uint32_t scale = mont_mul(mont_mul(n_inv, P->r2, P), P->r2, P);   // n^-1 * 2^64
+
+            build_roots(roots, n, w, P);
+            build_roots(iroots, n, pow_mod(w, P->p - 2, P->p), P);
+            load_residues(a, poly1, deg1, n, P->p);
+            load_residues(fb, poly2, deg2, n, P->p);
+
+            ntt_forward(a, n, roots, P, use_avx2);
+            ntt_forward(fb, n, roots, P, use_avx2);
+            if (use_avx2) pointwise_avx2(a, fb, n, scale, P);
+            else pointwise(a, fb, n, scale, P);
+            ntt_inverse(a, n, iroots, P, use_avx2);
+        }
+
+        #pragma omp for schedule(static)
+        for (int i = 0; i < result_len; ++i) {
+            result[i] = crt_combine(fa, n, i, nprimes);
+        }
+    }
+
+    free(fa);
+    free(fb);
+    free(roots);
+    free(iroots);
+    return result;
+}
+
+uint32_t ntt_prime(int k)
+{
+    return primes[k].p;
+}
+
+uint32_t ntt_root(int k, int log_len, int inverse)
+{
+    uint32_t p = primes[k].p;
+    uint32_t w = pow_mod(primes[k].g, (p - 1) >> log_len, p);
+    return inverse ? pow_mod(w, p - 2, p) : w;
+}
+
+uint32_t ntt_pow(int k, uint32_t x, uint64_t e)
+{
+    return pow_mod(x, e, primes[k].p);
+}
+
+void ntt_twiddle(uint32_t *a, int len, const int *index, uint32_t base, int k)
+{
+    init_primes();
+    const ntt_prime_t *P = &primes[k];
+    uint32_t base_mont = mont_mul(base % P->p, P->r2, P);
+    uint32_t x = mont_mul(1, P->r2, P);     // base^t in Montgomery form, so mont_mul(a, x) = a * base^t
+
+    for (int t = 0; t < len; ++t) {
+        int i = index ? index[t] : t;
+        a[i] = mont_mul(a[i], x, P);
+        x = mont_mul(x, base_mont, P);
+    }
+}
+
+void ntt_pointwise(uint32_t *out, const uint32_t *a, const uint32_t *b, size_t n, int log_len, int k, int threads)
+{
+    init_primes();
+    const ntt_prime_t *P = &primes[k];
+    uint32_t n_inv = pow_mod((uint32_t)(((uint64_t)1 << log_len) % P->p), P->p - 2, P->p);
+    uint32_t scale = mont_mul(mont_mul(n_inv, P->r2, P), P->r2, P);   // n^-1 * 2^64
+    if (threads <= 0) threads = omp_get_max_threads();
+
+    #pragma omp parallel for schedule(static) num_threads(threads)
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = mont_mul(mont_mul(a[i], b[i], P), scale, P);
+    }
+}
+
+void ntt_roots(uint32_t *roots, int log_len, int k, int inverse, int threads)
+{
+    init_primes();
+    if (threads <= 0) threads = omp_get_max_threads();
+
+    #pragma omp parallel num_threads(threads)
+    build_roots(roots, 1 << log_len, ntt_root(k, log_len, inverse), &primes[k]);
+}
+
+// Every stage with h < len pairs elements inside one length-len block only, and its
+// twiddles depend on h alone, so the whole batch runs as the last stages of one long transform.
+void ntt_forward_batch(uint32_t *a, int len, int count, const uint32_t *roots, int k, int threads)
+{
+    int n = len * count;
+    int use_avx2 = __builtin_cpu_supports("avx2");
+    if (threads <= 0) threads = omp_get_max_threads();
+    init_primes();
+
+    #pragma omp parallel num_threads(threads)
+    for (int h = len / 2; h >= 1; h /= 2) {
+        if (use_avx2 && h >= 8) dif_stage_avx2(a, n, h, roots, &primes[k]);
+        else dif_stage(a, n, h, roots, &primes[k]);
+    }
+}
+
+void ntt_inverse_batch(uint32_t *a, int len, int count, const uint32_t *iroots, int k, int threads)
+{
+    int n = len * count;
+    int use_avx2 = __builtin_cpu_supports("avx2");
+    if (threads <= 0) threads = omp_get_max_threads();
+    init_primes();
+
+    #pragma omp parallel num_threads(threads)
+    for (int h = 1; h < len; h *= 2) {
+        if (use_avx2 && h >= 8) dit_stage_avx2(a, n, h, iroots, &primes[k]);
+        else dit_stage(a, n, h, iroots, &primes[k]);
+    }
+}
+
+int ntt_crt(const uint32_t *residues, int nprimes)
+{
+    init_primes();
+    return crt_values(residues[0], residues[1], nprimes > 2 ? residues[2] : 0, nprimes);
+}
@@ -0,0 +1,47 @@
+#ifndef NTT_H
+#define NTT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define NTT_MAX_PRIMES 3
+#define NTT_MAX_LOG 26          // Largest power of two dividing p - 1 for every prime.
+
+// Exact polynomial multiplication with number-theoretic transforms over
+// NTT-friendly primes, recombined with CRT. The result matches the
+// schoolbook product coefficient for coefficient (modulo 2^32, like int).
+// threads <= 0 uses the OpenMP default thread count.
+int *multiply_ntt(const int *poly1, int deg1, const int *poly2, int deg2, int threads);
+
+// Building blocks for transforms whose stages are split across processes
+// (ergasia3/exercise1). Values are residues modulo ntt_prime(k); length-len
+// transforms take a table of len entries from ntt_roots().
+
+// Number of primes (2 or 3) for a product of terms-long inputs bounded by max1, max2.
+int ntt_primes_needed(uint64_t max1, uint64_t max2, int terms);
+uint32_t ntt_prime(int k);
+
+// Primitive 2^log_len-th root of unity mod prime k, or its inverse.
+uint32_t ntt_root(int k, int log_len, int inverse);
+
+// x^e mod prime k.
+uint32_t ntt_pow(int k, uint32_t x, uint64_t e);
+
+// Twiddle step of a split transform: a[index[t]] *= base^t mod prime k for t < len
+// (a[t] when index is NULL), with Montgomery multiplies instead of divisions.
+void ntt_twiddle(uint32_t *a, int len, const int *index, uint32_t base, int k);
+
+// out[i] = a[i] * b[i] / 2^log_len mod prime k: the pointwise step of a length-2^log_len
+// product, with the inverse transform's division folded in.
+void ntt_pointwise(uint32_t *out, const uint32_t *a, const uint32_t *b, size_t n, int log_len, int k, int threads);
+void ntt_roots(uint32_t *roots, int log_len, int k, int inverse, int threads);
+
+// count consecutive length-len transforms in place. Forward takes natural order
+// to bit-reversed order, inverse takes it back and does not divide by len.
+void ntt_forward_batch(uint32_t *a, int len, int count, const uint32_t *roots, int k, int threads);
+void ntt_inverse_batch(uint32_t *a, int len, int count, const uint32_t *iroots, int k, int threads);
+
+// Coefficient from its residues[0..nprimes), reduced to int like multiply_ntt.
+int ntt_crt(const uint32_t *residues, int nprimes);
+
+#endif
@@ -0,0 +1,120 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "poly.h"
+#include "rng.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <omp.h>
+
+static int *alloc_polynomial(int degree)
+{
+    int *poly = (int *)malloc((size_t)(degree + 1) * sizeof(int));
+    if (!poly) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    return poly;
+}
+
+static uint64_t poly_seed_value;
+static uint64_t poly_streams;       // polynomials drawn since the last poly_seed()
+static int poly_threads = 0;        // generator team size, 0 for the OpenMP default
+
+void poly_seed(uint64_t seed)
+{
+    poly_seed_value = seed;
+    poly_streams = 0;
+}
+
+uint64_t poly_next_stream(void)
+{
+    return rng_stream(poly_seed_value, poly_streams++);
+}
+
+void poly_set_threads(int threads)
+{
+    poly_threads = threads > 0 ? threads : 0;
+}
+
+static int generator_threads(void)
+{
+    return poly_threads > 0 ? poly_threads : omp_get_max_threads();
+}
+
+void poly_fill_random(int *dst, int first, int count, uint64_t stream)
+{
+    #pragma omp parallel for num_threads(generator_threads()) schedule(static)
+    for (int i = 0; i < count; ++i) {
+        dst[i] = rng_int(stream, (uint64_t)first + i, LOWER_BOUND, UPPER_BOUND);
+    }
+}
+
+int *create_random_polynomial(int degree)
+{
+    int *poly = alloc_polynomial(degree);
+    poly_fill_random(poly, 0, degree + 1, poly_next_stream());
+    return poly;
+}
+
+// Draws from the range with zero left out and shifts the upper half down by one.
+int *create_nonzero_polynomial(int degree)
+{
+    int *poly = alloc_polynomial(degree);
+    uint64_t stream = poly_next_stream();
+    #pragma omp parallel for num_threads(generator_threads()) schedule(static)
+    for (int i = 0; i <= degree; ++i) {
+        int r = rng_int(stream, (uint64_t)i, LOWER_BOUND, UPPER_BOUND - 1);
+        poly[i] = r >= 0 ? r + 1 : r;
+    }
+    return poly;
+}
+
+// Counter 2i decides whether coefficient i is nonzero, counter 2i + 1 gives its value.
+int *create_sparse_polynomial(int degree, double density)
+{
+    if (density >= 1.0) {
+        return create_random_polynomial(degree);
+    }
+    int *poly = alloc_polynomial(degree);
+    uint64_t stream = poly_next_stream();
+    #pragma omp parallel for num_threads(generator_threads()) schedule(static)
+    for (int i = 0; i <= degree; ++i) {
+        uint64_t k = 2 * (uint64_t)i;
+        poly[i] = rng_unit(stream, k) < density ? rng_int(stream, k + 1, LOWER_BOUND, UPPER_BOUND) : 0;
+    }
+    return poly;
+}
+
+int *multiply_sequential(const int *poly1, int deg1, const int *poly2, int deg2)
+{
+    int result_len = deg1 + deg2 + 1;
+    int *result = (int *)calloc((size_t)result_len, sizeof(int));
+    if (!result) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i <= deg1; ++i) {
+        for (int j = 0; j <= deg2; ++j) {
+            result[i + j] += poly1[i] * poly2[j];
+        }
+    }
+    return result;
+}
+
+int results_equal(const int *res1, const int *res2, int degree)
+{
+    for (int i = 0; i <= degree; ++i) {
+        if (res1[i] != res2[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
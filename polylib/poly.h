@@ -0,0 +1,41 @@
+#ifndef POLY_H
+#define POLY_H
+
+// Helpers shared by every driver: input generation, the reference product
+// and timing. Coefficients are drawn uniformly from [LOWER_BOUND, UPPER_BOUND].
+#define LOWER_BOUND -20
+#define UPPER_BOUND 20
+
+#include <stdint.h>
+
+// Coefficients come from the counter-based generator in rng.h: coefficient i of a
+// polynomial depends only on the seed, the polynomial's stream and i. Each
+// create_*_polynomial() call takes the next stream, so after poly_seed(s) the k-th
+// polynomial is the same for any thread count, and a process can draw just its own
+// slice of it with poly_fill_random().
+void poly_seed(uint64_t seed);
+uint64_t poly_next_stream(void);
+
+// Threads the generators below may use; <= 0 (the default) means the OpenMP default.
+// MPI drivers pass their per-rank count so ranks sharing a node do not oversubscribe it.
+void poly_set_threads(int threads);
+
+// Coefficients [first, first + count) of the random polynomial on stream into dst.
+void poly_fill_random(int *dst, int first, int count, uint64_t stream);
+
+int *create_random_polynomial(int degree);
+
+// Same range with zero excluded, so every coefficient contributes work.
+int *create_nonzero_polynomial(int degree);
+
+// Each coefficient is nonzero with probability density, zero otherwise.
+int *create_sparse_polynomial(int degree, double density);
+
+// Reference schoolbook product; the result has deg1 + deg2 + 1 coefficients.
+int *multiply_sequential(const int *poly1, int deg1, const int *poly2, int deg2);
+
+int results_equal(const int *res1, const int *res2, int degree);
+
+double now_seconds(void);
+
+#endif
@@ -0,0 +1,163 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include "dispatch.h"
+#include "poly.h"
+#include "polyio.h"
+#include "rng.h"
+#include "stream.h"
+
+// Streams raw native ints (poly1, of any length) from input or stdin through an overlap-add
+// convolution with a fixed poly2 and writes the product coefficients, as raw ints too, to
+// output or stdout as soon as each block of them is final. Statistics go to stderr.
+int main(int argc, char *argv[])
+{
+    const char *usage = "Usage: %s [-b block] [-t threads] {-f filter_file | -g degree} [input [output]]\n";
+    const char *filter_path = NULL;
+    int block = 0;
+    int threads = 0;
+    int gen_degree = -1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "b:t:f:g:")) != -1) {
+        if (opt == 'b' && atoi(optarg) > 0) {
+            block = atoi(optarg);
+        }
+        else if (opt == 't') {
+            threads = atoi(optarg);
+        }
+        else if (opt == 'f') {
+            filter_path = optarg;
+        }
+        else if (opt == 'g' && atoi(optarg) >= 0) {
+            gen_degree = atoi(optarg);
+        }
+        else {
+            fprintf(stderr, usage, argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if ((filter_path == NULL) == (gen_degree < 0) || argc - optind > 2) {
+        fprintf(stderr, usage, argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int in_fd = STDIN_FILENO, out_fd = STDOUT_FILENO;
+    if (argc - optind >= 1 && strcmp(argv[optind], "-") != 0) {
+        in_fd = open(argv[optind], O_RDONLY);
+        if (in_fd < 0) {
+            perror(argv[optind]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc - optind == 2 && strcmp(argv[optind + 1], "-") != 0) {
+        out_fd = open(argv[optind + 1], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (out_fd < 0) {
+            perror(argv[optind + 1]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    poly_file_t filter_file = {0};
+    int *poly2;
+    int deg2;
+    if (filter_path) {
+        if (poly_load(filter_path, &filter_file) != 0) {
+            return EXIT_FAILURE;
+        }
+        poly2 = filter_file.polys[0];
+        deg2 = filter_file.degrees[0];
+    }
+    else {
+        poly_seed(rng_default_seed());
+        poly2 = create_random_polynomial(gen_degree);
+        deg2 = gen_degree;
+    }
+
+    // Long enough that the carried deg2 sums are a small part of each block's work.
+    if (block == 0) {
+        block = 4 * (deg2 + 1) > 4096 ? 4 * (deg2 + 1) : 4096;
+    }
+
+    poly_conv_t conv;
+    poly_conv_init(&conv, poly2, deg2, block, threads);
+    int *in = (int *)malloc((size_t)block * sizeof(int));
+    int *out = (int *)malloc(((size_t)block + deg2) * sizeof(int));
+    if (!in || !out) {
+        perror("malloc");
+        return EXIT_FAILURE;
+    }
+
+    // Whatever a read returns is pushed at once, so a slow producer is not held back to full blocks.
+    size_t have = 0;
+    long long total = 0, blocks = 0;
+    double busy = 0, worst = 0;
+    double start = now_seconds();
+    for (;;) {
+        ssize_t n = read(in_fd, (char *)in + have, (size_t)block * sizeof(int) - have);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("read");
+            return EXIT_FAILURE;
+        }
+        if (n == 0) break;
+        have += (size_t)n;
+        int count = (int)(have / sizeof(int));
+        if (count == 0) continue;
+
+        double t0 = now_seconds();
+        poly_conv_push(&conv, in, count, out);
+        if (poly_write_all(out_fd, out, (size_t)count * sizeof(int)) != 0) {
+            perror("write");
+            return EXIT_FAILURE;
+        }
+        double latency = now_seconds() - t0;
+        busy += latency;
+        if (latency > worst) worst = latency;
+        ++blocks;
+        total += count;
+
+        memmove(in, (char *)in + (size_t)count * sizeof(int), have % sizeof(int));
+        have %= sizeof(int);
+    }
+    if (have != 0) {
+        fprintf(stderr, "Ignoring %zu trailing bytes that do not form a whole coefficient.\n", have);
+    }
+    int tail = poly_conv_flush(&conv, out);
+    if (poly_write_all(out_fd, out, (size_t)tail * sizeof(int)) != 0) {
+        perror("write");
+        return EXIT_FAILURE;
+    }
+    double elapsed = now_seconds() - start;
+
+    struct rusage resources;
+    getrusage(RUSAGE_SELF, &resources);
+    fprintf(stderr, "Convolved %lld coefficients with a degree %d poly2 in blocks of up to %d (engine %s x %d)\n",
+            total, deg2, block, poly_engine_name(conv.plan.engine), conv.plan.threads);
+    fprintf(stderr, "Blocks: %lld, latency mean %.3f ms, max %.3f ms\n",
+            blocks, blocks ? 1e3 * busy / blocks : 0.0, 1e3 * worst);
+    fprintf(stderr, "Throughput: %.2f M coefficients/s over %.3f seconds\n",
+            elapsed > 0 ? total / elapsed / 1e6 : 0.0, elapsed);
+    fprintf(stderr, "Peak RSS: %.1f MB\n", resources.ru_maxrss / 1024.0);
+
+    poly_conv_free(&conv);
+    free(in);
+    free(out);
+    if (filter_path) {
+        poly_unload(&filter_file);
+    }
+    else {
+        free(poly2);
+    }
+    if (out_fd != STDOUT_FILENO && close(out_fd) != 0) {
+        perror("close");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,164 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "polyio.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FNV_PRIME 0x100000001B3ull
+
+size_t poly_record_bytes(uint64_t degree)
+{
+    size_t bytes = (size_t)(degree + 1) * sizeof(int);
+    return (bytes + POLYIO_ALIGN - 1) / POLYIO_ALIGN * POLYIO_ALIGN;
+}
+
+int poly_write_all(int fd, const void *data, size_t bytes)
+{
+    const char *p = (const char *)data;
+    while (bytes > 0) {
+        ssize_t n = write(fd, p, bytes);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        bytes -= (size_t)n;
+    }
+    return 0;
+}
+
+uint64_t poly_checksum_update(uint64_t h, const int *coeffs, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        h = (h ^ (uint32_t)coeffs[i]) * FNV_PRIME;
+    }
+    return h;
+}
+
+uint64_t poly_checksum(const int *poly, int degree)
+{
+    return poly_checksum_update(POLYIO_CHECKSUM_INIT, poly, (size_t)degree + 1);
+}
+
+int poly_save(const char *path, int count, int *const *polys, const int *degrees)
+{
+    static const char zeros[POLYIO_ALIGN];
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    for (int p = 0; p < count; ++p) {
+        poly_header_t header = {POLYIO_MAGIC, POLYIO_VERSION, sizeof(int), (uint64_t)degrees[p],
+                                poly_checksum(polys[p], degrees[p]), {0}};
+        size_t bytes = (size_t)(degrees[p] + 1) * sizeof(int);
+        if (fwrite(&header, sizeof(header), 1, f) != 1
+            || fwrite(polys[p], 1, bytes, f) != bytes
+            || fwrite(zeros, 1, poly_record_bytes(degrees[p]) - bytes, f) != poly_record_bytes(degrees[p]) - bytes) {
+            perror(path);
+            fclose(f);
+            return -1;
+        }
+    }
+    if (fclose(f) != 0) {
+        perror(path);
+        return -1;
+    }
+    return 0;
+}
+
+int poly_load(const char *path, poly_file_t *file)
+{
+    return poly_map(path, file, 1);
+}
+
+int poly_map(const char *path, poly_file_t *file, int verify)
+{
+    memset(file, 0, sizeof(*file));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    file->length = (size_t)st.st_size;
+    // Private and writable, so callers get plain int * they may scribble on without touching the file.
+    file->map = file->length ? mmap(NULL, file->length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (file->map == MAP_FAILED) {
+        if (file->length) perror(path);
+        else fprintf(stderr, "%s: empty file\n", path);
+        file->map = NULL;
+        return -1;
+    }
+
+    size_t offset = 0;
+    while (offset < file->length && file->count < POLYIO_MAX_POLYS) {
+        const poly_header_t *header = (const poly_header_t *)((char *)file->map + offset);
+        if (file->length - offset < sizeof(*header) || memcmp(header->magic, POLYIO_MAGIC, 8) != 0
+            || header->version != POLYIO_VERSION) {
+            fprintf(stderr, "%s: not a polynomial file (record %d)\n", path, file->count);
+            poly_unload(file);
+            return -1;
+        }
+        if (header->width != sizeof(int) || header->degree > 0x7FFFFFFE
+            || file->length - offset - sizeof(*header) < poly_record_bytes(header->degree)) {
+            fprintf(stderr, "%s: record %d has width %u, degree %llu or is truncated\n", path, file->count,
+                    header->width, (unsigned long long)header->degree);
+            poly_unload(file);
+            return -1;
+        }
+        int *poly = (int *)((char *)file->map + offset + sizeof(*header));
+        if (verify && poly_checksum(poly, (int)header->degree) != header->checksum) {
+            fprintf(stderr, "%s: checksum mismatch in record %d\n", path, file->count);
+            poly_unload(file);
+            return -1;
+        }
+        file->polys[file->count] = poly;
+        file->degrees[file->count] = (int)header->degree;
+        file->count++;
+        offset += sizeof(*header) + poly_record_bytes(header->degree);
+    }
+    return 0;
+}
+
+void poly_unload(poly_file_t *file)
+{
+    if (file->map) munmap(file->map, file->length);
+    memset(file, 0, sizeof(*file));
+}
+
+void poly_load_pair(const char *path, poly_file_t *file, int **poly1, int *deg1, int **poly2, int *deg2)
+{
+    if (poly_load(path, file) != 0) {
+        exit(EXIT_FAILURE);
+    }
+    if (file->count < 2) {
+        fprintf(stderr, "%s: holds %d polynomial(s), two are needed\n", path, file->count);
+        exit(EXIT_FAILURE);
+    }
+    *poly1 = file->polys[0];
+    *deg1 = file->degrees[0];
+    *poly2 = file->polys[1];
+    *deg2 = file->degrees[1];
+}
+
+void poly_save_pair(const char *path, int *poly1, int deg1, int *poly2, int deg2)
+{
+    int *polys[2] = {poly1, poly2};
+    int degrees[2] = {deg1, deg2};
+    if (poly_save(path, 2, polys, degrees) != 0) {
+        exit(EXIT_FAILURE);
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef POLYIO_H
+#define POLYIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Binary polynomial files: one or more records, each a 64-byte header followed by
+// the raw little-endian coefficients padded to 64 bytes. Loading maps the file and
+// hands out pointers into the mapping, so nothing is copied or parsed per coefficient;
+// only the checksum pass touches the data.
+#define POLYIO_MAGIC "POLYBIN"      // 8 bytes with the terminator
+#define POLYIO_VERSION 1
+#define POLYIO_ALIGN 64
+#define POLYIO_MAX_POLYS 16
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t width;         // bytes per coefficient, always sizeof(int) so far
+    uint64_t degree;
+    uint64_t checksum;      // FNV-1a over the coefficient words
+    uint64_t reserved[4];
+} poly_header_t;
+
+typedef struct {
+    void *map;
+    size_t length;
+    int count;
+    int *polys[POLYIO_MAX_POLYS];   // copy-on-write views of the mapping
+    int degrees[POLYIO_MAX_POLYS];
+} poly_file_t;
+
+#define POLYIO_CHECKSUM_INIT 0xCBF29CE484222325ull
+
+uint64_t poly_checksum(const int *poly, int degree);
+
+// Folds count more coefficients into a running checksum started at POLYIO_CHECKSUM_INIT,
+// for writers that produce a polynomial a block at a time.
+uint64_t poly_checksum_update(uint64_t h, const int *coeffs, size_t count);
+
+// Bytes a record with this degree takes after its header.
+size_t poly_record_bytes(uint64_t degree);
+
+// write() until all bytes are out, retrying short writes and EINTR. Returns 0, or -1 with errno set.
+int poly_write_all(int fd, const void *data, size_t bytes);
+
+// Both return 0 on success, or print why and return -1.
+int poly_save(const char *path, int count, int *const *polys, const int *degrees);
+int poly_load(const char *path, poly_file_t *file);
+
+// poly_load() with the checksum pass optional: verify = 0 validates only the headers and
+// lengths, so no coefficient page is touched until the caller reads it.
+int poly_map(const char *path, poly_file_t *file, int verify);
+void poly_unload(poly_file_t *file);
+
+// The two inputs of a driver run: the first two polynomials in path. Exits on error.
+void poly_load_pair(const char *path, poly_file_t *file, int **poly1, int *deg1, int **poly2, int *deg2);
+void poly_save_pair(const char *path, int *poly1, int deg1, int *poly2, int deg2);
+
+#endif
@@ -0,0 +1,94 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "dispatch.h"
+#include "poly.h"
+#include "polyio.h"
+#include "rng.h"
+#include "stream.h"
+
+// Sizes like 512K, 64M or 2G.
+static size_t parse_size(const char *text)
+{
+    char *end;
+    double value = strtod(text, &end);
+    switch (*end) {
+    case 'G': case 'g': value *= 1024;  // fall through
+    case 'M': case 'm': value *= 1024;  // fall through
+    case 'K': case 'k': value *= 1024;
+    }
+    return value > 0 ? (size_t)value : 0;
+}
+
+// Out-of-core multiply of the two polynomials in a polyio file (as written by the
+// drivers' --save, or by -g here) into another polyio file, within a memory budget.
+int main(int argc, char *argv[])
+{
+    const char *usage = "Usage: %s [-m budget] [-t threads] [-g degree1,degree2] [-c] <input> <output>\n";
+    size_t budget = 64 << 20;
+    int threads = 0;
+    int gen1 = -1, gen2 = -1;
+    int check = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "m:t:g:c")) != -1) {
+        if (opt == 'm' && parse_size(optarg) > 0) {
+            budget = parse_size(optarg);
+        }
+        else if (opt == 't') {
+            threads = atoi(optarg);
+        }
+        else if (opt == 'g' && sscanf(optarg, "%d,%d", &gen1, &gen2) == 2 && gen1 >= 0 && gen2 >= 0) {
+            continue;
+        }
+        else if (opt == 'c') {
+            check = 1;
+        }
+        else {
+            fprintf(stderr, usage, argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc - optind != 2) {
+        fprintf(stderr, usage, argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char *in_path = argv[optind];
+    const char *out_path = argv[optind + 1];
+
+    poly_seed(rng_default_seed());
+    if (gen1 >= 0) {
+        double gen_start = now_seconds();
+        if (poly_stream_generate(in_path, gen1, gen2, budget) != 0) {
+            return EXIT_FAILURE;
+        }
+        printf("Generated %s (degrees %d and %d) in %.3f seconds\n", in_path, gen1, gen2, now_seconds() - gen_start);
+    }
+
+    poly_stream_stats_t stats;
+    if (poly_stream_multiply(in_path, out_path, budget, threads, &stats) != 0) {
+        return EXIT_FAILURE;
+    }
+    printf("Block: %zu coefficients (budget %.1f MB)\n", stats.block, budget / 1048576.0);
+    printf("Streamed %zu output blocks in %.3f seconds: %.3f GB processed, %.3f GB/s\n",
+           stats.blocks, stats.seconds, stats.bytes / 1e9, stats.bytes / 1e9 / stats.seconds);
+    printf("Waiting for the writer: %.3f seconds\n", stats.write_wait);
+    printf("Peak RSS: %.1f MB\n", stats.peak_rss_kb / 1024.0);
+
+    if (check) {
+        poly_file_t input, output;
+        if (poly_load(in_path, &input) != 0 || poly_load(out_path, &output) != 0) {
+            return EXIT_FAILURE;
+        }
+        int *expected = poly_multiply_threads(input.polys[0], input.degrees[0], input.polys[1], input.degrees[1], threads);
+        int degree = input.degrees[0] + input.degrees[1];
+        printf("Match in-memory multiply: %s\n",
+               output.degrees[0] == degree && results_equal(expected, output.polys[0], degree) ? "yes" : "no");
+        free(expected);
+        poly_unload(&input);
+        poly_unload(&output);
+    }
+    return EXIT_SUCCESS;
+}
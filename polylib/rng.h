@@ -0,0 +1,53 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Counter-based random numbers: value i of a stream is a hash of (stream, i), so
+// any element can be drawn on its own. Arrays filled in parallel, by any number of
+// threads or processes, come out bit-identical to a serial fill with the same seed.
+// The hash is the SplitMix64 finalizer over a Weyl sequence.
+#define RNG_GOLDEN 0x9E3779B97F4A7C15ull
+
+static inline uint64_t rng_mix(uint64_t x)
+{
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Independent stream number id under seed, e.g. one per generated array.
+static inline uint64_t rng_stream(uint64_t seed, uint64_t id)
+{
+    return rng_mix(seed ^ rng_mix((id + 1) * RNG_GOLDEN));
+}
+
+static inline uint64_t rng_at(uint64_t stream, uint64_t i)
+{
+    return rng_mix(stream + (i + 1) * RNG_GOLDEN);
+}
+
+// Uniform in [lo, hi] from the top 32 bits (multiply-shift, no modulo bias worth noting).
+static inline int rng_int(uint64_t stream, uint64_t i, int lo, int hi)
+{
+    uint64_t span = (uint64_t)((int64_t)hi - lo + 1);
+    return (int)((int64_t)lo + (int64_t)(((rng_at(stream, i) >> 32) * span) >> 32));
+}
+
+// Uniform in [0, 1) with 53 random bits.
+static inline double rng_unit(uint64_t stream, uint64_t i)
+{
+    return (double)(rng_at(stream, i) >> 11) * 0x1.0p-53;
+}
+
+// $RNG_SEED when set, so runs can be repeated exactly, otherwise the current time.
+static inline uint64_t rng_default_seed(void)
+{
+    const char *env = getenv("RNG_SEED");
+    if (env && *env) return strtoull(env, NULL, 0);
+    return (uint64_t)time(NULL);
+}
+
+#endif
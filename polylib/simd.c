@@ -0,0 +1,356 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "simd.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <immintrin.h>
+
+#define RB_ROWS 4                   // poly1 coefficients per register-blocked pass
+
+void simd_kernel_scalar(const int *poly1, int deg1, const int *poly2, int deg2, int *result) {
+    for(int i = 0; i <= deg1; ++i) {
+        int a = poly1[i];
+        int *res = result + i;
+        for(int j = 0; j <= deg2; ++j) {
+            res[j] += a * poly2[j];
+        }
+    }
+}
+
+__attribute__((target("sse4.1")))
+void simd_kernel_sse41(const int *poly1, int deg1, const int *poly2, int deg2, int *result) {
+    for(int i = 0; i <= deg1; ++i) {
+
+        __m128i p1_vec = _mm_set1_epi32(poly1[i]);
+
+        int j = 0;
+        for(; j <= deg2 - 3; j += 4) {
+            __m128i p2_vec = _mm_loadu_si128((__m128i*)&poly2[j]);
+            __m128i result_vec = _mm_loadu_si128((__m128i*)&result[i + j]);
+            result_vec = _mm_add_epi32(result_vec, _mm_mullo_epi32(p1_vec, p2_vec));
+            _mm_storeu_si128((__m128i*)&result[i + j], result_vec);
+        }
+
+        for(; j <= deg2; ++j) {    // Handle remaining coefficients.
+            result[i + j] += poly1[i] * poly2[j];
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+void simd_kernel_avx2(const int *poly1, int deg1, const int *poly2, int deg2, int *result) {
+    for(int i = 0; i <= deg1; ++i) {
+
+        __m256i p1_vec = _mm256_set1_epi32(poly1[i]);
+
+        int j = 0;
+        for(; j <= deg2 - 7; j += 8) {
+            __m256i p2_vec = _mm256_loadu_si256((__m256i*)&poly2[j]);
+
+            __m256i result_vec = _mm256_loadu_si256((__m256i*)&result[i + j]);
+
+            __m256i product = _mm256_mullo_epi32(p1_vec, p2_vec);
+
+            result_vec = _mm256_add_epi32(result_vec, product);
+
+            _mm256_storeu_si256((__m256i*)&result[i + j], result_vec);
+        }
+
+        for(; j <= deg2; ++j) {    // Handle remaining coefficients.
+            result[i + j] += poly1[i] * poly2[j];
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+void simd_kernel_avx512(const int *poly1, int deg1, const int *poly2, int deg2, int *result) {
+    for(int i = 0; i <= deg1; ++i) {
+
+        __m512i p1_vec = _mm512_set1_epi32(poly1[i]);
+
+        int j = 0;
+        for(; j <= deg2 - 15; j += 16) {
+            __m512i p2_vec = _mm512_loadu_si512(&poly2[j]);
+            __m512i result_vec = _mm512_loadu_si512(&result[i + j]);
+            result_vec = _mm512_add_epi32(result_vec, _mm512_mullo_epi32(p1_vec, p2_vec));
+            _mm512_storeu_si512(&result[i + j], result_vec);
+        }
+
+        if(j <= deg2) {            // Remaining coefficients go through one masked vector.
+            __mmask16 tail = (__mmask16)((1u << (deg2 - j + 1)) - 1);
+            __m512i p2_vec = _mm512_maskz_loadu_epi32(tail, &poly2[j]);
+            __m512i result_vec = _mm512_maskz_loadu_epi32(tail, &result[i + j]);
+            result_vec = _mm512_add_epi32(result_vec, _mm512_mullo_epi32(p1_vec, p2_vec));
+            _mm512_mask_storeu_epi32(&result[i + j], tail, result_vec);
+        }
+    }
+}
+
+typedef struct {
+    const char *name;
+    simd_kernel_fn kernel;
+} simd_isa_t;
+
+// Widest first; dispatch picks the first entry the CPU supports.
+static const simd_isa_t simd_isas[] = {
+    {"avx512", simd_kernel_avx512},
+    {"avx2", simd_kernel_avx2},
+    {"sse4.1", simd_kernel_sse41},
+    {"scalar", simd_kernel_scalar},
+};
+static const int simd_isa_count = sizeof(simd_isas) / sizeof(simd_isas[0]);
+
+simd_kernel_fn simd_kernel = simd_kernel_scalar;
+const char *simd_kernel_name = "scalar";
+
+static int cpu_supports_isa(const char *name) {
+    __builtin_cpu_init();
+    if(strcmp(name, "avx512") == 0) return __builtin_cpu_supports("avx512f");
+    if(strcmp(name, "avx2") == 0) return __builtin_cpu_supports("avx2");
+    if(strcmp(name, "sse4.1") == 0) return __builtin_cpu_supports("sse4.1");
+    return strcmp(name, "scalar") == 0;
+}
+
+// Selects the kernel for the forced ISA, or the widest supported one when forced is NULL.
+// Returns 0 if the forced ISA is unknown or not available on this CPU.
+int select_simd_kernel(const char *forced) {
+    for(int k = 0; k < simd_isa_count; ++k) {
+        if(forced && strcmp(forced, simd_isas[k].name) != 0) continue;
+        if(!cpu_supports_isa(simd_isas[k].name)) continue;
+        simd_kernel = simd_isas[k].kernel;
+        simd_kernel_name = simd_isas[k].name;
+        return 1;
+    }
+    return 0;
+}
+
+// Register-blocked micro-kernels: RB_ROWS consecutive poly1 coefficients are applied to the
+// same output vectors while they sit in registers, so result[] is loaded and stored once per
+// RB_ROWS rows instead of once per row. Output k = i0 + j gets a[r] * poly2[j - r] for each r.
+
+// Scalar edge of a row block: output offsets j in [j_lo, j_hi], skipping products outside poly2.
+static void regblock_edge(const int *a, const int *poly2, int deg2, int *res, int j_lo, int j_hi) {
+    for(int j = j_lo; j <= j_hi; ++j) {
+        int sum = 0;
+        for(int r = 0; r < RB_ROWS; ++r) {
+            int jj = j - r;
+            if(jj >= 0 && jj <= deg2) sum += a[r] * poly2[jj];
+        }
+        res[j] += sum;
+    }
+}
+
+__attribute__((target("avx2")))
+void regblock_kernel_avx2(const int *poly1, int deg1, const int *poly2, int deg2, int *result) {
+    int i0 = 0;
+    for(; i0 + RB_ROWS <= deg1 + 1; i0 += RB_ROWS) {
+        const int *a = poly1 + i0;
+        int *res = result + i0;
+        __m256i a0 = _mm256_set1_epi32(a[0]);
+        __m256i a1 = _mm256_set1_epi32(a[1]);
+        __m256i a2 = _mm256_set1_epi32(a[2]);
+        __m256i a3 = _mm256_set1_epi32(a[3]);
+
+        int j = RB_ROWS - 1;
+        regblock_edge(a, poly2, deg2, res, 0, j - 1);
+
+        for(; j + 15 <= deg2; j += 16) {        // Two result vectors in registers.
+            const int *p = poly2 + j;
+            __m256i acc0 = _mm256_loadu_si256((__m256i*)&res[j]);
+            __m256i acc1 = _mm256_loadu_si256((__m256i*)&res[j + 8]);
+            acc0 = _mm256_add_epi32(acc0, _mm256_mullo_epi32(a0, _mm256_loadu_si256((__m256i*)(p))));
+            acc1 = _mm256_add_epi32(acc1, _mm256_mullo_epi32(a0, _mm256_loadu_si256((__m256i*)(p + 8))));
+            acc0 = _mm256_add_epi32(acc0, _mm256_mullo_epi32(a1, _mm256_loadu_si256((__m256i*)(p - 1))));
+            acc1 = _mm256_add_epi32(acc1, _mm256_mullo_epi32(a1, _mm256_loadu_si256((__m256i*)(p + 7))));
+            acc0 = _mm256_add_epi32(acc0, _mm256_mullo_epi32(a2, _mm256_loadu_si256((__m256i*)(p - 2))));
+            acc1 = _mm256_add_epi32(acc1, _mm256_mullo_epi32(a2, _mm256_loadu_si256((__m256i*)(p + 6))));
+            acc0 = _mm256_add_epi32(acc0, _mm256_mullo_epi32(a3, _mm256_loadu_si256((__m256i*)(p - 3))));
+            acc1 = _mm256_add_epi32(acc1, _mm256_mullo_epi32(a3, _mm256_loadu_si256((__m256i*)(p + 5))));
+            _mm256_storeu_si256((__m256i*)&res[j], acc0);
+            _mm256_storeu_si256((__m256i*)&res[j + 8], acc1);
+        }
+
+        for(; j + 7 <= deg2; j += 8) {
+            const int *p = poly2 + j;
+            __m256i acc = _mm256_loadu_si256((__m256i*)&res[j]);
+            acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(a0, _mm256_loadu_si256((__m256i*)(p))));
+            acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(a1, _mm256_loadu_si256((__m256i*)(p - 1))));
+            acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(a2, _mm256_loadu_si256((__m256i*)(p - 2))));
+            acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(a3, _mm256_loadu_si256((__m256i*)(p - 3))));
+            _mm256_storeu_si256((__m256i*)&res[j], acc);
+        }
+
+        regblock_edge(a, poly2, deg2, res, j, deg2 + RB_ROWS - 1);
+    }
+
+    if(i0 <= deg1) {           // Leftover rows go through the plain kernel.
+        simd_kernel(poly1 + i0, deg1 - i0, poly2, deg2, result + i0);
+    }
+}
+
+__attribute__((target("avx512f")))
+void regblock_kernel_avx512(const int *poly1, int deg1, const int *poly2, int deg2, int *result) {
+    int i0 = 0;
+    for(; i0 + RB_ROWS <= deg1 + 1; i0 += RB_ROWS) {
+        const int *a = poly1 + i0;
+        int *res = result + i0;
+        __m512i a0 = _mm512_set1_epi32(a[0]);
+        __m512i a1 = _mm512_set1_epi32(a[1]);
+        __m512i a2 = _mm512_set1_epi32(a[2]);
+        __m512i a3 = _mm512_set1_epi32(a[3]);
+
+        int j = RB_ROWS - 1;
+        regblock_edge(a, poly2, deg2, res, 0, j - 1);
+
+        for(; j + 31 <= deg2; j += 32) {        // Two result vectors in registers.
+            const int *p = poly2 + j;
+            __m512i acc0 = _mm512_loadu_si512(&res[j]);
+            __m512i acc1 = _mm512_loadu_si512(&res[j + 16]);
+            acc0 = _mm512_add_epi32(acc0, _mm512_mullo_epi32(a0, _mm512_loadu_si512(p)));
+            acc1 = _mm512_add_epi32(acc1, _mm512_mullo_epi32(a0, _mm512_loadu_si512(p + 16)));
+            acc0 = _mm512_add_epi32(acc0, _mm512_mullo_epi32(a1, _mm512_loadu_si512(p - 1)));
+            acc1 = _mm512_add_epi32(acc1, _mm512_mullo_epi32(a1, _mm512_loadu_si512(p + 15)));
+            acc0 = _mm512_add_epi32(acc0, _mm512_mullo_epi32(a2, _mm512_loadu_si512(p - 2)));
+            acc1 = _mm512_add_epi32(acc1, _mm512_mullo_epi32(a2, _mm512_loadu_si512(p + 14)));
+            acc0 = _mm512_add_epi32(acc0, _mm512_mullo_epi32(a3, _mm512_loadu_si512(p - 3)));
+            acc1 = _mm512_add_epi32(acc1, _mm512_mullo_epi32(a3, _mm512_loadu_si512(p + 13)));
+            _mm512_storeu_si512(&res[j], acc0);
+            _mm512_storeu_si512(&res[j + 16], acc1);
+        }
+
+        for(; j + 15 <= deg2; j += 16) {
+            const int *p = poly2 + j;
+            __m512i acc = _mm512_loadu_si512(&res[j]);
+            acc = _mm512_add_epi32(acc, _mm512_mullo_epi32(a0, _mm512_loadu_si512(p)));
+            acc = _mm512_add_epi32(acc, _mm512_mullo_epi32(a1, _mm512_loadu_si512(p - 1)));
+            acc = _mm512_add_epi32(acc, _mm512_mullo_epi32(a2, _mm512_loadu_si512(p - 2)));
+            acc = _mm512_add_epi32(acc, _mm512_mullo_epi32(a3, _mm512_loadu_si512(p - 3)));
+            _mm512_storeu_si512(&res[j], acc);
+        }
+
+        regblock_edge(a, poly2, deg2, res, j, deg2 + RB_ROWS - 1);
+    }
+
+    if(i0 <= deg1) {           // Leftover rows go through the plain kernel.
+        simd_kernel(poly1 + i0, deg1 - i0, poly2, deg2, result + i0);
+    }
+}
+
+// Register-blocked variant matching the dispatched ISA, or NULL when it is narrower than AVX2.
+simd_kernel_fn select_regblock_kernel(void) {
+    if(simd_kernel == simd_kernel_avx512) return regblock_kernel_avx512;
+    if(simd_kernel == simd_kernel_avx2) return regblock_kernel_avx2;
+    return NULL;
+}
+
+// Fastest kernel for this CPU, leaving the simd_kernel selection untouched.
+simd_kernel_fn best_simd_kernel(void) {
+    if(cpu_supports_isa("avx512")) return regblock_kernel_avx512;
+    if(cpu_supports_isa("avx2")) return regblock_kernel_avx2;
+    if(cpu_supports_isa("sse4.1")) return simd_kernel_sse41;
+    return simd_kernel_scalar;
+}
+
+// Narrow (int16) coefficients. _mm256_madd_epi16 multiplies 16 int16 pairs and adds adjacent
+// products into 8 int32 lanes, so one instruction applies two poly1 rows: with
+// pairs[j] = (poly2[j], poly2[j - 1]) and a broadcast (a[i], a[i + 1]), lane l gets
+// a[i] * poly2[j + l] + a[i + 1] * poly2[j + l - 1], which belongs to result[i + j + l].
+
+int16_t* narrow_copy(const int *poly, int deg) {
+    int16_t *narrow = (int16_t *)malloc((size_t)(deg + 1) * sizeof(int16_t));
+    if(!narrow) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    for(int i = 0; i <= deg; ++i) {
+        narrow[i] = (int16_t)poly[i];
+    }
+    return narrow;
+}
+
+static long long max_abs_coefficient(const int *poly, int deg) {
+    long long best = 0;
+    for(int i = 0; i <= deg; ++i) {
+        long long v = poly[i] < 0 ? -(long long)poly[i] : poly[i];
+        if(v > best) best = v;
+    }
+    return best;
+}
+
+int narrow_range_safe(const int *poly1, int deg1, const int *poly2, int deg2) {
+    long long max1 = max_abs_coefficient(poly1, deg1);
+    long long max2 = max_abs_coefficient(poly2, deg2);
+    if(max1 > INT16_MAX || max2 > INT16_MAX) return 0;
+    long long terms = (deg1 < deg2 ? deg1 : deg2) + 1;
+    return max1 * max2 <= INT32_MAX / terms;
+}
+
+void narrow_kernel_scalar(const int16_t *poly1, int deg1, const int16_t *poly2, int deg2, int *result) {
+    for(int i = 0; i <= deg1; ++i) {
+        int a = poly1[i];
+        int *res = result + i;
+        for(int j = 0; j <= deg2; ++j) {
+            res[j] += a * poly2[j];
+        }
+    }
+}
+
+// Scalar edge of a row block of `rows` rows: output offsets j in [j_lo, j_hi].
+static void narrow_edge(const int16_t *a, int rows, const int16_t *poly2, int deg2, int *res, int j_lo, int j_hi) {
+    for(int j = j_lo; j <= j_hi; ++j) {
+        int sum = 0;
+        for(int r = 0; r < rows; ++r) {
+            int jj = j - r;
+            if(jj >= 0 && jj <= deg2) sum += a[r] * poly2[jj];
+        }
+        res[j] += sum;
+    }
+}
+
+static inline int32_t pack_int16_pair(int16_t lo, int16_t hi) {
+    return (int32_t)((uint32_t)(uint16_t)lo | ((uint32_t)(uint16_t)hi << 16));
+}
+
+// Four poly1 rows per pass: two madd instructions per result vector, one load/store.
+__attribute__((target("avx2")))
+void narrow_kernel_avx2(const int16_t *poly1, int deg1, const int16_t *poly2, int deg2, int *result) {
+    int32_t *pairs = (int32_t *)malloc((size_t)(deg2 + 2) * sizeof(int32_t));
+    if(!pairs) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    for(int j = 0; j <= deg2 + 1; ++j) {
+        pairs[j] = pack_int16_pair(j <= deg2 ? poly2[j] : 0, j >= 1 ? poly2[j - 1] : 0);
+    }
+
+    int i0 = 0;
+    for(; i0 + 4 <= deg1 + 1; i0 += 4) {
+        const int16_t *a = poly1 + i0;
+        int *res = result + i0;
+        __m256i a01 = _mm256_set1_epi32(pack_int16_pair(a[0], a[1]));
+        __m256i a23 = _mm256_set1_epi32(pack_int16_pair(a[2], a[3]));
+
+        int j = 2;
+        narrow_edge(a, 4, poly2, deg2, res, 0, j - 1);
+
+        for(; j + 7 <= deg2 + 1; j += 8) {
+            __m256i acc = _mm256_loadu_si256((__m256i*)&res[j]);
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a01, _mm256_loadu_si256((__m256i*)&pairs[j])));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a23, _mm256_loadu_si256((__m256i*)&pairs[j - 2])));
+            _mm256_storeu_si256((__m256i*)&res[j], acc);
+        }
+
+        narrow_edge(a, 4, poly2, deg2, res, j, deg2 + 3);
+    }
+
+    if(i0 <= deg1) {           // Leftover rows.
+        narrow_edge(poly1 + i0, deg1 - i0 + 1, poly2, deg2, result + i0, 0, deg2 + deg1 - i0);
+    }
+    free(pairs);
+}
+
+narrow_kernel_fn select_narrow_kernel(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? narrow_kernel_avx2 : narrow_kernel_scalar;
+}
@@ -0,0 +1,48 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <stdint.h>
+
+// Kernels for each instruction set are compiled with target attributes, so a binary runs
+// on any x86-64 host and simd_kernel is pointed at the widest one the CPU supports at startup.
+// Each accumulates poly1 * poly2 into result (result must hold deg1 + deg2 + 1 ints).
+typedef void (*simd_kernel_fn)(const int *poly1, int deg1, const int *poly2, int deg2, int *result);
+
+void simd_kernel_scalar(const int *poly1, int deg1, const int *poly2, int deg2, int *result);
+void simd_kernel_sse41(const int *poly1, int deg1, const int *poly2, int deg2, int *result);
+void simd_kernel_avx2(const int *poly1, int deg1, const int *poly2, int deg2, int *result);
+void simd_kernel_avx512(const int *poly1, int deg1, const int *poly2, int deg2, int *result);
+
+// Register-blocked variants: several poly1 rows per pass with the result vectors kept in registers.
+void regblock_kernel_avx2(const int *poly1, int deg1, const int *poly2, int deg2, int *result);
+void regblock_kernel_avx512(const int *poly1, int deg1, const int *poly2, int deg2, int *result);
+
+extern simd_kernel_fn simd_kernel;
+extern const char *simd_kernel_name;
+
+// Selects the kernel for the forced ISA (avx512, avx2, sse4.1, scalar), or the widest
+// supported one when forced is NULL. Returns 0 if the forced ISA is unknown or unavailable.
+int select_simd_kernel(const char *forced);
+
+// Register-blocked variant matching the dispatched ISA, or NULL when it is narrower than AVX2.
+simd_kernel_fn select_regblock_kernel(void);
+
+// Fastest kernel for this CPU (register-blocked where available), leaving simd_kernel untouched.
+simd_kernel_fn best_simd_kernel(void);
+
+// Narrow path for bounded coefficients: int16 storage, products accumulated in int32.
+typedef void (*narrow_kernel_fn)(const int16_t *poly1, int deg1, const int16_t *poly2, int deg2, int *result);
+
+void narrow_kernel_scalar(const int16_t *poly1, int deg1, const int16_t *poly2, int deg2, int *result);
+void narrow_kernel_avx2(const int16_t *poly1, int deg1, const int16_t *poly2, int deg2, int *result);
+
+// Returns 1 when every coefficient fits in int16 and no exact product coefficient can
+// leave int32, i.e. the narrow path gives the same result as the int kernels.
+int narrow_range_safe(const int *poly1, int deg1, const int *poly2, int deg2);
+
+int16_t* narrow_copy(const int *poly, int deg);
+
+// The madd-based AVX2 kernel when the CPU has AVX2, else the scalar one.
+narrow_kernel_fn select_narrow_kernel(void);
+
+#endif
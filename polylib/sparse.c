@@ -0,0 +1,263 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "sparse.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <omp.h>
+
+#define SPARSE_TERM_COST 16     // Dense mul-adds per hashed term product: ~4 with cached tables, ~40 once they spill.
+#define EMPTY_SLOT -1
+
+typedef struct {
+    int *keys;
+    unsigned *vals;             // unsigned so partial sums wrap like the dense kernels
+    int mask;
+    sparse_term_t *sorted;      // table contents after compaction
+    int count;
+} term_table_t;
+
+static void *xmalloc(size_t bytes, const char *what)
+{
+    void *p = malloc(bytes ? bytes : 1);
+    if (!p) {
+        perror(what);
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+int count_nonzero(const int *poly, int degree)
+{
+    int nnz = 0;
+    for (int i = 0; i <= degree; ++i) {
+        nnz += poly[i] != 0;
+    }
+    return nnz;
+}
+
+sparse_poly_t sparse_from_dense(const int *poly, int degree)
+{
+    sparse_poly_t sp;
+    sp.nnz = count_nonzero(poly, degree);
+    sp.terms = (sparse_term_t *)xmalloc((size_t)sp.nnz * sizeof(sparse_term_t), "malloc sparse");
+    int k = 0;
+    for (int i = 0; i <= degree; ++i) {
+        if (poly[i] != 0) {
+            sp.terms[k].exp = i;
+            sp.terms[k].coeff = poly[i];
+            ++k;
+        }
+    }
+    return sp;
+}
+
+int *sparse_to_dense(const sparse_poly_t *poly, int degree)
+{
+    int *dense = (int *)calloc((size_t)degree + 1, sizeof(int));
+    if (!dense) {
+        perror("calloc sparse");
+        exit(EXIT_FAILURE);
+    }
+    for (int k = 0; k < poly->nnz && poly->terms[k].exp <= degree; ++k) {
+        dense[poly->terms[k].exp] = poly->terms[k].coeff;
+    }
+    return dense;
+}
+
+void sparse_free(sparse_poly_t *poly)
+{
+    free(poly->terms);
+    poly->terms = NULL;
+    poly->nnz = 0;
+}
+
+int sparse_preferred(int nnz1, int deg1, int nnz2, int deg2)
+{
+    double sparse_cost = (double)nnz1 * nnz2 * SPARSE_TERM_COST;
+    double dense_cost = ((double)deg1 + 1) * ((double)deg2 + 1);
+    return sparse_cost < dense_cost;
+}
+
+static inline unsigned hash_exp(int exp, int mask)
+{
+    return ((uint32_t)exp * 2654435761u) & (unsigned)mask;
+}
+
+static int compare_terms(const void *a, const void *b)
+{
+    int ea = ((const sparse_term_t *)a)->exp;
+    int eb = ((const sparse_term_t *)b)->exp;
+    return (ea > eb) - (ea < eb);
+}
+
+// Open addressing with linear probing, sized to at most half full.
+static void table_init(term_table_t *t, long max_terms)
+{
+    int cap = 16;
+    while (cap < 2 * max_terms) {
+        cap <<= 1;
+    }
+    t->keys = (int *)xmalloc((size_t)cap * sizeof(int), "malloc sparse table");
+    t->vals = (unsigned *)xmalloc((size_t)cap * sizeof(unsigned), "malloc sparse table");
+    t->mask = cap - 1;
+    t->sorted = NULL;
+    t->count = 0;
+    for (int s = 0; s < cap; ++s) {
+        t->keys[s] = EMPTY_SLOT;
+    }
+}
+
+static inline void table_add(term_table_t *t, int exp, unsigned val)
+{
+    unsigned s = hash_exp(exp, t->mask);
+    while (t->keys[s] != exp) {
+        if (t->keys[s] == EMPTY_SLOT) {
+            t->keys[s] = exp;
+            t->vals[s] = 0;
+            break;
+        }
+        s = (s + 1) & (unsigned)t->mask;
+    }
+    t->vals[s] += val;
+}
+
+// Drops cancelled terms and sorts the rest by exponent, freeing the table.
+static void table_compact(term_table_t *t)
+{
+    int n = 0;
+    for (int s = 0; s <= t->mask; ++s) {
+        n += t->keys[s] != EMPTY_SLOT && t->vals[s] != 0;
+    }
+    t->sorted = (sparse_term_t *)xmalloc((size_t)n * sizeof(sparse_term_t), "malloc sparse table");
+    int k = 0;
+    for (int s = 0; s <= t->mask; ++s) {
+        if (t->keys[s] != EMPTY_SLOT && t->vals[s] != 0) {
+            t->sorted[k].exp = t->keys[s];
+            t->sorted[k].coeff = (int)t->vals[s];
+            ++k;
+        }
+    }
+    t->count = n;
+    free(t->keys);
+    free(t->vals);
+    qsort(t->sorted, (size_t)n, sizeof(sparse_term_t), compare_terms);
+}
+
+// First index in a sorted term list whose exponent is >= exp.
+static int lower_bound(const sparse_term_t *terms, int count, int exp)
+{
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (terms[mid].exp < exp) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+sparse_poly_t multiply_sparse(const sparse_poly_t *poly1, const sparse_poly_t *poly2, int threads)
+{
+    sparse_poly_t product = {NULL, 0};
+    if (poly1->nnz == 0 || poly2->nnz == 0) {
+        product.terms = (sparse_term_t *)xmalloc(0, "malloc sparse");
+        return product;
+    }
+    if (threads <= 0) threads = omp_get_max_threads();
+
+    const sparse_term_t *a = poly1->terms;
+    const sparse_term_t *b = poly2->terms;
+    int nnz1 = poly1->nnz, nnz2 = poly2->nnz;
+    int max_exp = a[nnz1 - 1].exp + b[nnz2 - 1].exp;
+
+    term_table_t *tables = (term_table_t *)xmalloc((size_t)threads * sizeof(term_table_t), "malloc sparse");
+    sparse_term_t **merged = (sparse_term_t **)xmalloc((size_t)threads * sizeof(sparse_term_t *), "malloc sparse");
+    int *merged_count = (int *)xmalloc((size_t)threads * sizeof(int), "malloc sparse");
+    int team = 1;
+
+    #pragma omp parallel num_threads(threads)
+    {
+        int tid = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+        #pragma omp single
+        team = nt;
+
+        // Phase 1: each thread multiplies a contiguous run of poly1 terms
+        // by all of poly2 into a private table.
+        int first = (int)((long)nnz1 * tid / nt);
+        int last = (int)((long)nnz1 * (tid + 1) / nt);
+        term_table_t *table = &tables[tid];
+        if (first < last) {
+            long span = (long)(a[last - 1].exp - a[first].exp) + (b[nnz2 - 1].exp - b[0].exp) + 1;
+            long pairs = (long)(last - first) * nnz2;
+            table_init(table, pairs < span ? pairs : span);
+            for (int i = first; i < last; ++i) {
+                unsigned ca = (unsigned)a[i].coeff;
+                int ea = a[i].exp;
+                for (int j = 0; j < nnz2; ++j) {
+                    table_add(table, ea + b[j].exp, ca * (unsigned)b[j].coeff);
+                }
+            }
+            table_compact(table);
+        }
+        else {
+            table->sorted = NULL;
+            table->count = 0;
+        }
+        #pragma omp barrier
+
+        // Phase 2: thread t merges exponents [lo, hi) out of every table.
+        int lo = (int)((long)(max_exp + 1) * tid / nt);
+        int hi = (int)((long)(max_exp + 1) * (tid + 1) / nt);
+        int pos[nt], end[nt];
+        long total = 0;
+        for (int s = 0; s < nt; ++s) {
+            pos[s] = lower_bound(tables[s].sorted, tables[s].count, lo);
+            end[s] = lower_bound(tables[s].sorted, tables[s].count, hi);
+            total += end[s] - pos[s];
+        }
+        sparse_term_t *out = (sparse_term_t *)xmalloc((size_t)total * sizeof(sparse_term_t), "malloc sparse");
+        int n = 0;
+        for (;;) {
+            int next = hi;
+            for (int s = 0; s < nt; ++s) {
+                if (pos[s] < end[s] && tables[s].sorted[pos[s]].exp < next) {
+                    next = tables[s].sorted[pos[s]].exp;
+                }
+            }
+            if (next == hi) break;
+            unsigned sum = 0;
+            for (int s = 0; s < nt; ++s) {
+                if (pos[s] < end[s] && tables[s].sorted[pos[s]].exp == next) {
+                    sum += (unsigned)tables[s].sorted[pos[s]++].coeff;
+                }
+            }
+            if (sum != 0) {
+                out[n].exp = next;
+                out[n].coeff = (int)sum;
+                ++n;
+            }
+        }
+        merged[tid] = out;
+        merged_count[tid] = n;
+    }
+
+    for (int t = 0; t < team; ++t) {
+        product.nnz += merged_count[t];
+    }
+    product.terms = (sparse_term_t *)xmalloc((size_t)product.nnz * sizeof(sparse_term_t), "malloc sparse");
+    int offset = 0;
+    for (int t = 0; t < team; ++t) {
+        for (int k = 0; k < merged_count[t]; ++k) {
+            product.terms[offset + k] = merged[t][k];
+        }
+        offset += merged_count[t];
+        free(merged[t]);
+        free(tables[t].sorted);
+    }
+
+    free(tables);
+    free(merged);
+    free(merged_count);
+    return product;
+}
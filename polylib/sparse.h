@@ -0,0 +1,30 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+// Sparse polynomials as (exponent, coefficient) terms sorted by exponent,
+// zero coefficients dropped. Products are exact modulo 2^32, like int.
+typedef struct {
+    int exp;
+    int coeff;
+} sparse_term_t;
+
+typedef struct {
+    sparse_term_t *terms;
+    int nnz;
+} sparse_poly_t;
+
+sparse_poly_t sparse_from_dense(const int *poly, int degree);
+int *sparse_to_dense(const sparse_poly_t *poly, int degree);
+void sparse_free(sparse_poly_t *poly);
+
+// Nonzero coefficients of a dense polynomial.
+int count_nonzero(const int *poly, int degree);
+
+// 1 when multiplying nnz1 x nnz2 terms through hash tables is expected to
+// beat the (deg1 + 1) x (deg2 + 1) dense loop.
+int sparse_preferred(int nnz1, int deg1, int nnz2, int deg2);
+
+// threads <= 0 uses the OpenMP default thread count.
+sparse_poly_t multiply_sparse(const sparse_poly_t *poly1, const sparse_poly_t *poly2, int threads);
+
+#endif
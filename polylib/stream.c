@@ -0,0 +1,377 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE             // madvise(MADV_DONTNEED); posix_madvise's DONTNEED is a no-op in glibc
+
+#include "stream.h"
+#include "poly.h"
+#include "polyio.h"
+#include "kernels.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <omp.h>
+
+#define STREAM_SLICE 512            // output coefficients per work item inside a block
+
+// One kernel step: rows [a, ae] of poly1 into output block [o, o + len), which needs
+// poly2[jlo..jhi].
+typedef struct {
+    long long o, len, a, ae, jlo, jhi;
+} step_t;
+
+typedef struct {
+    const int *poly1, *poly2;
+    long long deg1, deg2, out_len, block;
+} plan_t;
+
+// Output double buffer shared with the writer thread. Slot s is full while the writer owns it.
+typedef struct {
+    int fd;
+    int *buf[2];
+    size_t len[2];
+    int full[2];
+    int stop;
+    int error;                      // errno of the first failed write, 0 if none
+    uint64_t checksum;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} writer_t;
+
+static void *xmalloc(size_t bytes, const char *what)
+{
+    void *p = malloc(bytes ? bytes : 1);
+    if (!p) {
+        perror(what);
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+// Record padding after count coefficients, and the header written last once the checksum is known.
+static int finish_record(int fd, off_t header_at, uint64_t degree, uint64_t checksum)
+{
+    static const char zeros[POLYIO_ALIGN];
+    poly_header_t header = {POLYIO_MAGIC, POLYIO_VERSION, sizeof(int), degree, checksum, {0}};
+    size_t pad = poly_record_bytes(degree) - (size_t)(degree + 1) * sizeof(int);
+    if (poly_write_all(fd, zeros, pad) != 0) return -1;
+    return pwrite(fd, &header, sizeof(header), header_at) == (ssize_t)sizeof(header) ? 0 : -1;
+}
+
+size_t poly_stream_block(size_t budget)
+{
+    size_t block = budget / (5 * sizeof(int)) / STREAM_MIN_BLOCK * STREAM_MIN_BLOCK;
+    return block < STREAM_MIN_BLOCK ? STREAM_MIN_BLOCK : block;
+}
+
+static void make_step(const plan_t *p, long long o, long long a, step_t *s)
+{
+    long long len = p->out_len - o < p->block ? p->out_len - o : p->block;
+    long long i_hi = o + len - 1 < p->deg1 ? o + len - 1 : p->deg1;
+    s->o = o;
+    s->len = len;
+    s->a = a;
+    s->ae = a + p->block - 1 < i_hi ? a + p->block - 1 : i_hi;
+    s->jlo = o - s->ae > 0 ? o - s->ae : 0;
+    s->jhi = o + len - 1 - a < p->deg2 ? o + len - 1 - a : p->deg2;
+}
+
+// Rows are swept in blocks from the lowest row that reaches the output block; 0 after the last step.
+static int next_step(const plan_t *p, const step_t *cur, step_t *next)
+{
+    long long i_hi = cur->o + cur->len - 1 < p->deg1 ? cur->o + cur->len - 1 : p->deg1;
+    if (cur->ae < i_hi) {
+        make_step(p, cur->o, cur->ae + 1, next);
+        return 1;
+    }
+    long long o = cur->o + cur->len;
+    if (o >= p->out_len) return 0;
+    make_step(p, o, o - p->deg2 > 0 ? o - p->deg2 : 0, next);
+    return 1;
+}
+
+static void advise(const int *base, long long lo, long long hi, int advice)
+{
+    if (lo > hi) return;
+    uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)(base + lo) & ~(page - 1);
+    uintptr_t end = (uintptr_t)(base + hi + 1);
+    madvise((void *)start, end - start, advice);
+}
+
+// Gives back the pages of [lo, hi] that the next step does not read, i.e. outside [keep_lo, keep_hi].
+static void release(const int *base, long long lo, long long hi, long long keep_lo, long long keep_hi)
+{
+    if (keep_lo > keep_hi) {
+        advise(base, lo, hi, MADV_DONTNEED);
+        return;
+    }
+    advise(base, lo, (hi < keep_lo - 1 ? hi : keep_lo - 1), MADV_DONTNEED);
+    advise(base, (lo > keep_hi + 1 ? lo : keep_hi + 1), hi, MADV_DONTNEED);
+}
+
+// Accumulates rows [a, ae] into the output block, one STREAM_SLICE of outputs per work item.
+// Indices fit in int: poly_stream_multiply rejects products longer than a polynomial file allows.
+static void compute_step(const plan_t *p, const step_t *s, int *out, int threads)
+{
+    long long slices = (s->len + STREAM_SLICE - 1) / STREAM_SLICE;
+    #pragma omp parallel for num_threads(threads) schedule(static, 1)
+    for (long long sl = 0; sl < slices; ++sl) {
+        long long ks = s->o + sl * STREAM_SLICE;
+        long long ke = ks + STREAM_SLICE - 1 < s->o + s->len - 1 ? ks + STREAM_SLICE - 1 : s->o + s->len - 1;
+        accumulate_output_range(p->poly1, (int)s->a, (int)s->ae, p->poly2, (int)p->deg2,
+                                (int)ks, (int)ke, out + (ks - s->o));
+    }
+}
+
+static void *writer_main(void *arg)
+{
+    writer_t *w = (writer_t *)arg;
+    int slot = 0;
+    for (;;) {
+        pthread_mutex_lock(&w->lock);
+        while (!w->full[slot] && !w->stop) {
+            pthread_cond_wait(&w->cond, &w->lock);
+        }
+        int have = w->full[slot];
+        pthread_mutex_unlock(&w->lock);
+        if (!have) break;
+
+        w->checksum = poly_checksum_update(w->checksum, w->buf[slot], w->len[slot]);
+        if (!w->error && poly_write_all(w->fd, w->buf[slot], w->len[slot] * sizeof(int)) != 0) {
+            w->error = errno;
+        }
+
+        pthread_mutex_lock(&w->lock);
+        w->full[slot] = 0;
+        pthread_cond_broadcast(&w->cond);
+        pthread_mutex_unlock(&w->lock);
+        slot ^= 1;
+    }
+    return NULL;
+}
+
+int poly_stream_multiply(const char *in_path, const char *out_path, size_t budget, int threads,
+                         poly_stream_stats_t *stats)
+{
+    if (threads <= 0) threads = omp_get_max_threads();
+    memset(stats, 0, sizeof(*stats));
+
+    poly_file_t input;
+    if (poly_map(in_path, &input, 0) != 0) return -1;
+    if (input.count < 2) {
+        fprintf(stderr, "%s: holds %d polynomial(s), two are needed\n", in_path, input.count);
+        poly_unload(&input);
+        return -1;
+    }
+    plan_t plan = {input.polys[0], input.polys[1], input.degrees[0], input.degrees[1],
+                   (long long)input.degrees[0] + input.degrees[1] + 1, (long long)poly_stream_block(budget)};
+    if (plan.out_len - 1 > 0x7FFFFFFE) {
+        fprintf(stderr, "%s: product degree %lld is too large for a polynomial file\n", in_path, plan.out_len - 1);
+        poly_unload(&input);
+        return -1;
+    }
+
+    writer_t w = {0};
+    w.fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (w.fd < 0) {
+        perror(out_path);
+        poly_unload(&input);
+        return -1;
+    }
+    poly_header_t blank = {{0}, 0, 0, 0, 0, {0}};
+    if (poly_write_all(w.fd, &blank, sizeof(blank)) != 0) {
+        perror(out_path);
+        close(w.fd);
+        poly_unload(&input);
+        return -1;
+    }
+    w.buf[0] = (int *)xmalloc((size_t)plan.block * sizeof(int), "malloc stream buffer");
+    w.buf[1] = (int *)xmalloc((size_t)plan.block * sizeof(int), "malloc stream buffer");
+    w.checksum = POLYIO_CHECKSUM_INIT;
+    pthread_mutex_init(&w.lock, NULL);
+    pthread_cond_init(&w.cond, NULL);
+    pthread_t writer;
+    if (pthread_create(&writer, NULL, writer_main, &w) != 0) {
+        perror("pthread_create");
+        exit(EXIT_FAILURE);
+    }
+
+    double start = now_seconds();
+    double swept = 0;
+    int slot = 0;
+    int *out = w.buf[0];
+    step_t cur, next;
+    make_step(&plan, 0, 0, &cur);
+    advise(plan.poly1, cur.a, cur.ae, MADV_WILLNEED);
+    advise(plan.poly2, cur.jlo, cur.jhi, MADV_WILLNEED);
+    memset(out, 0, (size_t)cur.len * sizeof(int));
+
+    for (;;) {
+        // Announce the next step before computing this one, so its pages arrive meanwhile.
+        int more = next_step(&plan, &cur, &next);
+        if (more) {
+            advise(plan.poly1, next.a, next.ae, MADV_WILLNEED);
+            advise(plan.poly2, next.jlo, next.jhi, MADV_WILLNEED);
+        }
+        compute_step(&plan, &cur, out, threads);
+        swept += (double)(cur.ae - cur.a + 1 + cur.jhi - cur.jlo + 1) * sizeof(int);
+        release(plan.poly1, cur.a, cur.ae, more ? next.a : 1, more ? next.ae : 0);
+        release(plan.poly2, cur.jlo, cur.jhi, more ? next.jlo : 1, more ? next.jhi : 0);
+
+        if (!more || next.o != cur.o) {
+            pthread_mutex_lock(&w.lock);
+            w.len[slot] = (size_t)cur.len;
+            w.full[slot] = 1;
+            pthread_cond_broadcast(&w.cond);
+            pthread_mutex_unlock(&w.lock);
+            stats->blocks++;
+            if (!more) break;
+
+            slot ^= 1;
+            double wait_start = now_seconds();
+            pthread_mutex_lock(&w.lock);
+            while (w.full[slot]) {
+                pthread_cond_wait(&w.cond, &w.lock);
+            }
+            pthread_mutex_unlock(&w.lock);
+            stats->write_wait += now_seconds() - wait_start;
+            out = w.buf[slot];
+            memset(out, 0, (size_t)next.len * sizeof(int));
+        }
+        cur = next;
+    }
+
+    pthread_mutex_lock(&w.lock);
+    w.stop = 1;
+    pthread_cond_broadcast(&w.cond);
+    pthread_mutex_unlock(&w.lock);
+    pthread_join(writer, NULL);
+
+    int status = 0;
+    if (w.error) {
+        errno = w.error;
+        status = -1;
+    }
+    else if (finish_record(w.fd, 0, (uint64_t)plan.out_len - 1, w.checksum) != 0) {
+        status = -1;
+    }
+    if (status != 0) perror(out_path);
+    if (close(w.fd) != 0 && status == 0) {
+        perror(out_path);
+        status = -1;
+    }
+
+    stats->seconds = now_seconds() - start;
+    stats->block = (size_t)plan.block;
+    stats->bytes = swept + (double)plan.out_len * sizeof(int);
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    stats->peak_rss_kb = usage.ru_maxrss;
+
+    pthread_mutex_destroy(&w.lock);
+    pthread_cond_destroy(&w.cond);
+    free(w.buf[0]);
+    free(w.buf[1]);
+    poly_unload(&input);
+    return status;
+}
+
+int poly_stream_generate(const char *path, int deg1, int deg2, size_t budget)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+    size_t block = poly_stream_block(budget);
+    int *buf = (int *)xmalloc(block * sizeof(int), "malloc stream buffer");
+    int degrees[2] = {deg1, deg2};
+    off_t header_at = 0;
+    int status = 0;
+
+    for (int p = 0; p < 2 && status == 0; ++p) {
+        uint64_t stream = poly_next_stream();
+        uint64_t checksum = POLYIO_CHECKSUM_INIT;
+        poly_header_t blank = {{0}, 0, 0, 0, 0, {0}};
+        status = poly_write_all(fd, &blank, sizeof(blank));
+        for (long long first = 0; first <= degrees[p] && status == 0; first += (long long)block) {
+            int count = degrees[p] + 1 - first < (long long)block ? (int)(degrees[p] + 1 - first) : (int)block;
+            poly_fill_random(buf, (int)first, count, stream);
+            checksum = poly_checksum_update(checksum, buf, (size_t)count);
+            status = poly_write_all(fd, buf, (size_t)count * sizeof(int));
+        }
+        if (status == 0) status = finish_record(fd, header_at, (uint64_t)degrees[p], checksum);
+        header_at += (off_t)(sizeof(poly_header_t) + poly_record_bytes((uint64_t)degrees[p]));
+    }
+    if (status != 0) perror(path);
+    if (close(fd) != 0 && status == 0) {
+        perror(path);
+        status = -1;
+    }
+    free(buf);
+    return status;
+}
+
+void poly_conv_init(poly_conv_t *conv, const int *poly2, int deg2, int block, int threads)
+{
+    conv->poly2 = poly2;
+    conv->deg2 = deg2;
+    conv->block = block;
+    conv->plan = poly_plan(block - 1, deg2, threads);
+    conv->kernel = conv->plan.engine == POLY_ENGINE_SIMD ? best_simd_kernel() : simd_kernel_scalar;
+    conv->work = (int *)xmalloc(((size_t)block + deg2) * sizeof(int), "malloc conv buffer");
+    conv->tail = (int *)calloc((size_t)deg2 + 1, sizeof(int));
+    if (!conv->tail) {
+        perror("calloc conv buffer");
+        exit(EXIT_FAILURE);
+    }
+    conv->consumed = 0;
+}
+
+void poly_conv_push(poly_conv_t *conv, const int *in, int count, int *out)
+{
+    int deg2 = conv->deg2;
+    for (int first = 0; first < count; first += conv->block) {
+        int n = count - first < conv->block ? count - first : conv->block;
+        size_t len = (size_t)n + deg2;
+        if (conv->plan.engine == POLY_ENGINE_SIMD || conv->plan.engine == POLY_ENGINE_SERIAL) {
+            memset(conv->work, 0, len * sizeof(int));
+            conv->kernel(in + first, n - 1, conv->poly2, deg2, conv->work);
+        }
+        else {
+            int *product = poly_multiply_plan(in + first, n - 1, conv->poly2, deg2, conv->plan);
+            memcpy(conv->work, product, len * sizeof(int));
+            free(product);
+        }
+        // Overlap-add: the carried sums land on the first deg2 outputs of this block; the
+        // first n are now final and the rest become the carry for the next block.
+        for (int k = 0; k < deg2; ++k) {
+            conv->work[k] += conv->tail[k];
+        }
+        memcpy(out + first, conv->work, (size_t)n * sizeof(int));
+        memcpy(conv->tail, conv->work + n, (size_t)deg2 * sizeof(int));
+        conv->consumed += n;
+    }
+}
+
+int poly_conv_flush(poly_conv_t *conv, int *out)
+{
+    if (conv->consumed == 0) return 0;
+    memcpy(out, conv->tail, (size_t)conv->deg2 * sizeof(int));
+    memset(conv->tail, 0, (size_t)conv->deg2 * sizeof(int));
+    conv->consumed = 0;
+    return conv->deg2;
+}
+
+void poly_conv_free(poly_conv_t *conv)
+{
+    free(conv->work);
+    free(conv->tail);
+    conv->work = conv->tail = NULL;
+}
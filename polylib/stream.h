@@ -0,0 +1,63 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stddef.h>
+#include "dispatch.h"
+
+// Out-of-core multiply for products that do not fit in memory as three arrays. The
+// inputs are the first two records of a polyio file, mapped without reading them; the
+// product is built one output block at a time and appended to a polyio file by a writer
+// thread, so I/O overlaps compute. Resident input pages are released as soon as a block
+// is done and the next block is announced to the kernel for read-ahead, keeping the
+// working set near the block budget whatever the polynomial sizes.
+#define STREAM_MIN_BLOCK 1024       // coefficients; one 4 KB page of ints
+
+typedef struct {
+    size_t block;           // output coefficients per block
+    size_t blocks;          // output blocks written
+    double seconds;
+    double bytes;           // input bytes swept by the kernel plus output bytes written
+    double write_wait;      // compute stalled waiting for a free output buffer
+    long peak_rss_kb;       // getrusage() high-water mark of the whole process
+} poly_stream_stats_t;
+
+// Block length for a budget in bytes: one poly1 block, a two-block poly2 window and
+// two output buffers have to fit in it.
+size_t poly_stream_block(size_t budget);
+
+// Multiplies the two polynomials in in_path into a one-record polyio file at out_path.
+// threads <= 0 uses the OpenMP default. Returns 0, or prints why and returns -1.
+int poly_stream_multiply(const char *in_path, const char *out_path, size_t budget, int threads,
+                         poly_stream_stats_t *stats);
+
+// Overlap-add convolution of an unbounded coefficient stream (poly1) with a fixed poly2,
+// e.g. a FIR filter: every pushed block is multiplied on its own and its last deg2 sums
+// are carried into the next block. Memory and work per block depend only on the block
+// length and deg2, never on how much of the stream has gone by.
+typedef struct {
+    const int *poly2;
+    int deg2;
+    int block;                  // largest block multiplied at once
+    poly_plan_t plan;           // engine for a block x poly2 product
+    simd_kernel_fn kernel;      // used in place for the SIMD and serial plans
+    int *work;                  // block + deg2 ints
+    int *tail;                  // deg2 sums still waiting for later inputs
+    long long consumed;
+} poly_conv_t;
+
+// poly2 must stay valid until poly_conv_free(). threads <= 0 allows the OpenMP default.
+void poly_conv_init(poly_conv_t *conv, const int *poly2, int deg2, int block, int threads);
+
+// Consumes count coefficients and writes the count outputs they complete to out.
+void poly_conv_push(poly_conv_t *conv, const int *in, int count, int *out);
+
+// Writes the last deg2 outputs once the stream has ended; returns how many (0 for an empty stream).
+int poly_conv_flush(poly_conv_t *conv, int *out);
+
+void poly_conv_free(poly_conv_t *conv);
+
+// Writes two random polynomials (the next two poly_next_stream() streams, so the same
+// ones create_random_polynomial() would return) to path without holding either in memory.
+int poly_stream_generate(const char *path, int deg1, int deg2, size_t budget);
+
+#endif